@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Texture.h"
 #include "GameObjects.h"
+#include "SpriteBatch.h"
 #include <vector>
 #include <SDL.h>
 
@@ -10,6 +11,7 @@ class Boss {
 public:
     std::vector<Texture*> frames;
     float x = 0.0f, y = 0.0f, vx = 0.0f, vy = 0.0f;
+    float prevX = 0.0f, prevY = 0.0f; // position at the previous simulation step
     int width = 32, height = 48;
     float hp = 10.0f;
     float invulnTimer = 0.0f;
@@ -24,5 +26,6 @@ public:
     float animationTimer = 0.0f;
 
     void update(float dt, Player& player, std::vector<Projectile>& projectiles, Texture& zelazo, int levelW);
-    void render(SDL_Renderer* ren, int camX, int camY, float scale);
+    // alpha blends from the previous step's position (0) to the current one (1)
+    void render(SpriteBatch& batch, int camX, int camY, float scale, float alpha = 1.0f);
 };
@@ -3,10 +3,65 @@
 #include "Enemy.h"
 #include "Boss.h"
 #include "Level.h"
-#include "SaveData.h"
+#include <cstdint>
+#include <vector>
 
 namespace Collision {
-    void resolvePlayerCollisions(Player& player, Level& level, int cellW, int cellH, SaveData& saveData);
+    // Something physics wants the rest of the game to react to. Tile and health changes
+    // happen on the spot; score, sounds, saving and particles wait for the event.
+    struct Event {
+        enum Type : uint8_t {
+            PICKUP,       // points: score to add
+            KEY,          // the key was collected
+            DAMAGE,       // the player lost health (already taken off)
+            ENEMY_KILLED, // x, y: the guard's left edge and middle, w: its width
+        };
+        Type type;
+        int row = -1, col = -1; // tile behind the event, if any
+        int points = 0;
+        float x = 0.0f, y = 0.0f;
+        int w = 0;
+    };
+
+    // Events of one frame, filled during the physics steps and handled once they are done.
+    // The storage is kept between frames, so pushing normally doesn't allocate.
+    class EventQueue {
+    public:
+        explicit EventQueue(size_t capacity = 256) { events.reserve(capacity); }
+        void push(const Event& e) { events.push_back(e); }
+        void clear() { events.clear(); }
+        bool empty() const { return events.empty(); }
+        std::vector<Event>::const_iterator begin() const { return events.begin(); }
+        std::vector<Event>::const_iterator end() const { return events.end(); }
+
+    private:
+        std::vector<Event> events;
+    };
+
+    // First tile a moving box runs into. t is the fraction of the move (0-1) done before
+    // touching it; normal points out of the tile face that was hit.
+    struct SweepHit {
+        bool hit = false;
+        float t = 1.0f;
+        int normalX = 0, normalY = 0;
+        int row = -1, col = -1;
+    };
+
+    // Sweeps the box (left, top, w, h) by (dx, dy) against the resident tiles with any of
+    // the given Tiles flags. Tiles the box already overlaps are ignored.
+    SweepHit sweepTiles(const Level& level, float left, float top, float w, float h, float dx, float dy,
+                        int cellW, int cellH, uint8_t flags);
+    // Time of impact of box a moving by (dx, dy) against the static box b; false if it
+    // misses or already overlaps it.
+    bool sweepBox(float aLeft, float aTop, float aw, float ah, float dx, float dy,
+                  float bLeft, float bTop, float bw, float bh, float& t, int& normalX, int& normalY);
+    // True if box a touches b anywhere on its way from (fromLeft, fromTop) to (toLeft, toTop).
+    bool sweptOverlap(float fromLeft, float fromTop, float toLeft, float toTop, float aw, float ah,
+                      float bLeft, float bTop, float bw, float bh);
+
+    // The resolvers sweep each body from its position at the previous simulation step
+    // (prevX/prevY) before pushing it out of anything it still overlaps.
+    void resolvePlayerCollisions(Player& player, Level& level, int cellW, int cellH, EventQueue& events);
     void resolveEnemyCollisions(Enemy& enemy, Level& level, int cellW, int cellH);
     void resolveBossCollisions(Boss& boss, Level& level, int cellW, int cellH);
 }
@@ -1,27 +1,17 @@
 #ifndef ENEMY_H
 #define ENEMY_H
 
-#include "Texture.h"
-#include <vector>
-#include <SDL.h>
-
+// One guard as a standalone body. The game keeps its guards in an EnemyPool and only
+// builds these to hand a single guard to the tile collision resolver.
 class Enemy {
 public:
     float x = 200.f, y = 800.f;
+    float prevX = 200.f, prevY = 800.f; // position at the previous simulation step
     float vx = 50.f; // horizontal speed
     float vy = 0.f;
     bool onGround = false;
     bool facingLeft = false;
-    std::vector<Texture*> frames;
-    int curFrame = 0;
-    double frameTime = 0;
-    double frameDelay = 200.0; // ms per frame
     int width = 32, height = 32;
-    bool active = true;
-    bool isDead = false;
-
-    void update(double dt, int levelWidth);
-    void render(SDL_Renderer* r, int camX, int camY, float renderScale = 1.0f);
 };
 
 #endif // ENEMY_H
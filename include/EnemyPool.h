@@ -0,0 +1,73 @@
+#ifndef ENEMY_POOL_H
+#define ENEMY_POOL_H
+
+#include "Enemy.h"
+#include "Texture.h"
+#include "SpriteBatch.h"
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+
+// All guards of a level, one array per field so the per-step update can move several
+// guards at once with SIMD. Index i in every array is the same guard. Guards are kept
+// sorted by x, so the ones in a stretch of the level are one index range and the rest
+// can sleep untouched; indices change when guards are reordered or removed.
+class EnemyPool {
+public:
+    enum Flag : uint8_t {
+        ON_GROUND = 1 << 0,
+        FACING_LEFT = 1 << 1,
+        DEAD = 1 << 2,     // playing the death animation, no longer moves
+        INACTIVE = 1 << 3, // death animation finished, dropped by removeInactive()
+    };
+
+    // Shared by every guard
+    std::vector<Texture*> frames;
+    int width = 32, height = 48;
+    double frameDelay = 200.0; // ms per frame
+
+    std::vector<float> x, y;         // left, feet
+    std::vector<float> prevX, prevY; // position at the previous simulation step
+    std::vector<float> vx, vy;
+    std::vector<double> frameTime;   // ms into the current frame
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> flags;
+    // Set by the caller before update() for the guards in its range; guards that are not
+    // awake keep still
+    std::vector<uint8_t> awake;
+
+    size_t size() const { return x.size(); }
+    void clear();
+    // Call sortByX() once the spawns are in
+    void spawn(float left, float feet, float speed);
+    void sortByX();
+    void kill(size_t i);
+    // Drops the guards whose death animation finished
+    void removeInactive();
+
+    // Index range of the guards whose left edge is in [left, right]
+    size_t lowerBound(float left) const;
+    size_t upperBound(float right) const;
+
+    // The per-step calls only touch guards [begin, end); the rest are left exactly as they
+    // are and carry on from there once a later range takes them in again.
+    void savePrevious(size_t begin, size_t end);
+    // Moves every awake guard by one step of gravity and patrol motion, bouncing off the
+    // level's sides, and advances the animations.
+    void update(double dt, int levelWidth, size_t begin, size_t end);
+    // Puts the guards back in x order after [begin, end) moved
+    void restoreOrder(size_t begin, size_t end);
+
+    // Copies guard i out to / back from a standalone body for tile collision
+    Enemy body(size_t i) const;
+    void setBody(size_t i, const Enemy& e);
+
+    // alpha blends from the previous step's position (0) to the current one (1)
+    void render(SpriteBatch& batch, int camX, int camY, float renderScale, float alpha, size_t begin, size_t end) const;
+
+private:
+    void integrate(size_t begin, size_t end, float dt, float levelWidth);
+    void swapGuards(size_t a, size_t b);
+};
+
+#endif // ENEMY_POOL_H
@@ -0,0 +1,22 @@
+#pragma once
+#include <SDL_ttf.h>
+#include <map>
+#include <string>
+#include <utility>
+
+// Fonts opened once per file and point size and shared by everything that draws text.
+class FontCache {
+public:
+    FontCache() = default;
+    ~FontCache();
+    FontCache(const FontCache&) = delete;
+    FontCache& operator=(const FontCache&) = delete;
+
+    // nullptr if the font can't be opened; a failed font is not retried
+    TTF_Font* get(const std::string& path, int size);
+    // Closes every font; call before TTF_Quit
+    void clear();
+
+private:
+    std::map<std::pair<std::string, int>, TTF_Font*> fonts;
+};
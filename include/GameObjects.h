@@ -3,6 +3,7 @@
 
 struct Projectile {
     float x, y, vx, vy;
+    float prevX = 0.0f, prevY = 0.0f; // position at the previous simulation step
     Texture* tex;
     bool active;
     bool fromPlayer = false;
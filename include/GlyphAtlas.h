@@ -0,0 +1,67 @@
+#pragma once
+#include "SpriteBatch.h"
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// The glyphs of one font rasterized once, in white, into a single texture; text is
+// drawn as tinted quads from it instead of rendering a new surface per string.
+// Glyphs are added the first time a string uses them.
+class GlyphAtlas {
+public:
+    struct Glyph {
+        SDL_Rect src; // line-height cell holding the glyph, drawn with its top at the line top
+        int advance;
+    };
+
+    GlyphAtlas(SDL_Renderer* r, TTF_Font* font);
+    ~GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // nullptr if the font lacks ch or the atlas is full
+    const Glyph* glyph(Uint16 ch);
+    SDL_Texture* texture() const { return tex; }
+    int lineHeight() const { return height; }
+    // Frees the texture; call before SDL_Quit
+    void clear();
+
+private:
+    static const int SIZE = 512;
+    static const int PAD = 1;
+
+    SDL_Renderer* ren = nullptr;
+    TTF_Font* font = nullptr;
+    SDL_Texture* tex = nullptr;
+    int height = 0;
+    int penX = 0, penY = 0, rowH = 0;
+    std::unordered_map<Uint16, Glyph> glyphs;
+    std::unordered_set<Uint16> missing; // not in the font, or didn't fit
+};
+
+// A string laid out against a GlyphAtlas. set() only redoes the layout when the text
+// changes, so a HUD value that stays the same costs nothing to keep drawing.
+class TextLabel {
+public:
+    // Returns true if the text changed
+    bool set(GlyphAtlas& atlas, const std::string& utf8);
+    int width() const { return w; }
+    int height() const { return h; }
+    // Queues the label with its top-left corner at (x, y)
+    void draw(SpriteBatch& batch, int x, int y, SDL_Color color) const;
+
+private:
+    struct Placed {
+        SDL_Rect src;
+        int x;
+    };
+
+    GlyphAtlas* atlas = nullptr;
+    std::string text;
+    bool laidOut = false;
+    std::vector<Placed> glyphs;
+    int w = 0, h = 0;
+};
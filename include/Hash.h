@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit FNV-1a. Used to recognise identical asset payloads, not for security.
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 1469598103934665603ull) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
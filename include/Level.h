@@ -2,13 +2,21 @@
 #define LEVEL_H
 
 #include <SDL.h>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "SolidBits.h"
+#include "PatrolField.h"
+
+class LevelStream;
 
 class Level {
 public:
     Level();
     ~Level();
+    Level(Level&& other) noexcept;
+    Level& operator=(Level&& other) noexcept;
 
     void updateBackground(float dt);
     void renderBackground(SDL_Renderer* renderer);
@@ -30,19 +38,124 @@ public:
 
     int rows;
     int cols;
-    std::vector<std::vector<int>> grid;
+    // Resident tiles, gridRows x gridCols starting at level cell (gridRow0, gridCol0), row-major
+    // with gridStride bytes per row. For streamed levels this is only the window around the
+    // camera; otherwise it is the whole level and the origin is 0,0. The buffer may hold spare
+    // rows and columns past the used ones (always zero) so the editor can grow the level cheaply.
+    std::vector<uint8_t> grid;
+    int gridRow0 = 0;
+    int gridCol0 = 0;
+    int gridRows = 0;
+    int gridCols = 0;
+    int gridStride = 0;
     std::string backgroundPath;
+    // Encoded background image embedded in the loaded archive (empty if none)
+    std::vector<char> backgroundData;
     std::vector<std::string> usedAssets;
     std::vector<std::pair<int, int>> enemyPositions;
 
+    // Levels with more tiles than this are saved as chunks and streamed on load
+    static const int STREAM_MIN_TILES = 65536;
+
+    // Tile access in level coordinates; cells outside the resident window read as empty.
+    int tile(int r, int c) const {
+        return isResident(r, c) ? grid[(size_t)(r - gridRow0) * gridStride + (c - gridCol0)] : 0;
+    }
+    // Same without the bounds check, for loops already clamped to the resident window.
+    uint8_t tileUnchecked(int r, int c) const {
+        return grid[(size_t)(r - gridRow0) * gridStride + (c - gridCol0)];
+    }
+    void setTile(int r, int c, int value);
+    // Replaces the layout with an empty rows x cols level.
+    void reset(int rows, int cols);
+    bool isResident(int r, int c) const {
+        return (unsigned)(r - gridRow0) < (unsigned)gridRows && (unsigned)(c - gridCol0) < (unsigned)gridCols;
+    }
+    bool isStreamed() const { return stream != nullptr; }
+
+    // Solid tile (Tiles::F_SOLID) queries in level coordinates, answered from per-row and
+    // per-column bitsets. Cells outside the resident window are not solid.
+    bool isSolid(int r, int c) const { return solid.test(r - gridRow0, c - gridCol0); }
+    // First solid row at or below r in column c, or -1.
+    int firstSolidBelow(int r, int c) const;
+    bool anySolidInSpan(int r, int c0, int c1) const;
+    // First solid column met walking row r from c0 towards c1 (either direction), or -1.
+    int raycastRow(int r, int c0, int c1) const;
+    // Distances to platform edges and walls for enemy patrols, kept up to date with setTile.
+    // Outside the resident window there is no ground and no known wall.
+    PatrolCell patrolAt(int r, int c) const { return patrol.at(r - gridRow0, c - gridCol0); }
+
+    // Loads the chunks around the view and drops the ones far from it.
+    // Does nothing for levels that are fully resident.
+    void streamAround(float camX, float camY, int viewW, int viewH, int tilePx);
+
+    // Adds the number of tiles of each value (0-255) in the whole level to counts;
+    // streamed levels are read chunk by chunk from the archive.
+    void countTiles(uint32_t counts[256]) const;
+
+    // Bumped by every bulk change of the tiles (load, streaming, resize); single cells
+    // changed by setTile are listed for takeTileEdits() instead. Render caches use both.
+    uint32_t layoutRevision() const { return revision; }
+    // Moves the cells changed since the last call into out (level coordinates).
+    void takeTileEdits(std::vector<std::pair<int, int>>& out);
+
+    // Writes enemyPositions into the grid as spawn tiles (5).
+    void markEnemySpawns();
+    // Rebuilds enemyPositions from the spawn tiles; spawns outside the resident window are kept.
+    void collectEnemySpawns();
+
     void toggleCell(int r, int c);
     void ensureCell(int r, int c);
 
-    bool saveToZip(const std::string& path, const std::string& assetsDir) const;
+    // Binary layout.bin loads fastest; Text writes a hand-editable layout.txt with
+    // run-length encoded rows (streamed levels are always saved as Binary).
+    enum class LayoutFormat { Binary, Text };
 
+    // Writes the layout, assets.txt and the background image to a temporary file
+    // that then replaces path.
+    bool saveToZip(const std::string& path, const std::string& assetsDir, LayoutFormat format = LayoutFormat::Binary);
+
+    // Copy of everything saveToZip writes, detached from this level so it can be saved
+    // on another thread. A streamed level's copy opens its own handle on the archive.
+    Level snapshot() const;
+    // Writes the archive straight to path (no temporary file).
+    bool writeZip(const std::string& path, const std::string& assetsDir, LayoutFormat format = LayoutFormat::Binary) const;
+    // Renames a finished archive over path. If this level streams from path it switches
+    // to the new file; dropStash is only safe if the file holds all edits made so far.
+    bool replaceArchive(const std::string& tmpPath, const std::string& path, bool dropStash);
+    // True if this level streams its tiles from the archive at path.
+    bool readsFrom(const std::string& path) const;
+
+    // Reads layout.bin when present, otherwise the text layout.txt.
+    // On failure the level is left unchanged.
     bool loadFromFile(const std::string& path);
 
+    // Moves the layout (grid, enemies, assets, background data) out of a level
+    // loaded elsewhere, keeping this level's rendering state.
+    void takeLayout(Level& other);
+
 private:
+    bool readArchive(const std::string& path);
+    std::string serializeBinaryLayout(bool chunked) const;
+    std::string serializeTextLayout() const;
+    bool parseBinaryLayout(const char* data, size_t size, bool& chunked);
+    void parseTextLayout(const char* data, size_t size);
+
+    void resizeGrid(int newRows, int newCols);
+    void reserveGrid(int capRows, int capCols);
+    void rebuildSolid();
+    void setWindow(int cy0, int cy1, int cx0, int cx1);
+    void copyChunk(int cy, int cx, uint8_t* out) const;
+
+    // Past this many untaken edits the list is dropped and the revision bumped instead
+    static const size_t MAX_TILE_EDITS = 4096;
+
+    std::unique_ptr<LevelStream> stream;
+    uint32_t revision = 0;
+    std::vector<std::pair<int, int>> tileEdits;
+    SolidBits solid;
+    PatrolField patrol;
+
     SDL_Texture* bgTexture = nullptr;
     bool bgRepeat = false;
     float scrollSpeed = 0.0f;
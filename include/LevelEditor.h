@@ -4,7 +4,7 @@
 class LevelEditor {
 public:
     LevelEditor(Level* l, int w, int h, float scale = 1.0f, int baseTile = 32);
-    void handleMouse(float mx, float my, float camX_editor_f);
+    void handleMouse(float mx, float my, float camX_editor_f, float camY_editor_f = 0.0f);
 
 private:
     Level* level;
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr const char* LEVEL_MANIFEST_FILE = "levels.manifest";
+
+// Metadata of one level archive, as recorded in the manifest
+struct LevelInfo {
+    int number = 0;
+    std::string file;            // archive file name, level_<number>.zip
+    int64_t mtime = 0;           // last write time of the archive (filesystem clock ticks)
+    uint64_t fileSize = 0;
+    uint64_t contentHash = 0;    // hashBytes() of the whole archive
+    int rows = 0;
+    int cols = 0;
+    std::string backgroundPath;
+    uint32_t enemyCount = 0;
+    uint32_t pickupCount = 0;
+    uint64_t layoutOffset = 0;     // offsets of the layout and background data in the archive
+    uint64_t backgroundOffset = 0;
+};
+
+// Index of the level_N.zip archives in a directory, cached in a small text file so the
+// menu can list levels without opening any archive. An entry is rebuilt only when its
+// archive's size or mtime changed and its contents hash differently.
+class LevelManifest {
+public:
+    // Loads the manifest, brings it up to date with the archives in dir and writes it back
+    // if anything changed. Returns the number of entries rebuilt from their archives.
+    int refresh(const std::string& dir = ".", const std::string& manifestPath = LEVEL_MANIFEST_FILE);
+
+    const std::vector<LevelInfo>& levels() const { return entries; } // sorted by number
+    const LevelInfo* find(int number) const;
+    bool empty() const { return entries.empty(); }
+
+private:
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    static bool build(const std::string& zipPath, LevelInfo& info);
+
+    std::vector<LevelInfo> entries;
+};
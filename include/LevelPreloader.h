@@ -0,0 +1,79 @@
+#pragma once
+#include "Level.h"
+#include <SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// A level read and decoded on the preloader thread; only the GPU upload is left.
+struct PreloadedLevel {
+    int number = 0;
+    bool loaded = false;                // level_N.zip was found and parsed
+    Level level;
+    SDL_Surface* background = nullptr;  // decoded background (RGBA32), owned
+    uint64_t backgroundHash = 0;        // hash of the encoded bytes (TextureCache key)
+    uint64_t fileSize = 0;              // archive size and last write time when it was read;
+    int64_t mtime = 0;                  // a level whose archive changed since is read again
+
+    PreloadedLevel() = default;
+    PreloadedLevel(const PreloadedLevel&) = delete;
+    PreloadedLevel& operator=(const PreloadedLevel&) = delete;
+    ~PreloadedLevel();
+};
+
+// A sprite file and the height it is drawn at, in logical pixels
+struct PreloadSprite {
+    std::string file;
+    int drawH;
+};
+
+// Worker thread that speculatively loads levels while the main menu is shown.
+// Sprite sheets are decoded and scaled for the display once up front; levels are loaded
+// around the menu cursor.
+class LevelPreloader {
+public:
+    // Sprites are scaled to drawH * displayScale pixels tall
+    LevelPreloader(const std::string& assetsDir, std::vector<PreloadSprite> spriteList, float displayScale);
+    ~LevelPreloader();
+
+    // Queue a level (1-based) and its neighbours; the most recent request runs first.
+    void prefetch(int levelNumber, int maxLevel);
+    // Hands over a preloaded level, waiting if the worker is busy with it.
+    // Returns nullptr if the level was never requested.
+    std::unique_ptr<PreloadedLevel> take(int levelNumber);
+    // Decoded and scaled sprite surface by file name (owned by the preloader), nullptr if it failed.
+    SDL_Surface* sprite(const std::string& file);
+    float displayScale() const { return scale; }
+
+    void shutdown();
+
+private:
+    void run();
+    std::unique_ptr<PreloadedLevel> load(int levelNumber);
+    void trimCache(int around);
+    // Drops a cached level whose archive was saved or replaced since it was read
+    void dropIfStale(int levelNumber);
+
+    static const size_t MAX_CACHED = 4;
+
+    std::string assetsDir;
+    std::vector<PreloadSprite> spriteFiles;
+    float scale;
+    std::unordered_map<std::string, SDL_Surface*> sprites;
+    bool spritesReady = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<int> pending;
+    std::map<int, std::unique_ptr<PreloadedLevel>> ready;
+    int inFlight = 0;
+    bool stopping = false;
+    std::thread worker;
+};
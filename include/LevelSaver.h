@@ -0,0 +1,58 @@
+#pragma once
+#include "Level.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes levels on a worker thread so the editor never waits on compression or disk.
+// save() only snapshots the level; the archive is written to <path>.tmp and renamed over
+// the target. Requests for a path that is still queued replace the queued snapshot, so a
+// burst of saves ends up as a single write.
+class LevelSaver {
+public:
+    struct Result {
+        std::string path;
+        bool ok = false;
+    };
+
+    LevelSaver();
+    ~LevelSaver();
+
+    void save(const Level& level, const std::string& path, const std::string& assetsDir);
+
+    // Call once per frame. Finishes saves over the archive `level` streams from (that
+    // rename has to happen here, with the level's handle closed) and returns the saves
+    // completed since the last call.
+    std::vector<Result> poll(Level& level);
+
+    // Waits until every queued save is written.
+    std::vector<Result> finish(Level& level);
+
+    // Writes what is still queued and stops the worker; call finish() first if a save
+    // may be waiting for poll().
+    void shutdown();
+
+private:
+    struct Job {
+        std::string path;
+        std::string assetsDir;
+        std::unique_ptr<Level> level;
+        bool replaceOnMainThread = false;
+    };
+
+    void run();
+    bool idleLocked() const { return queue.empty() && !writing && awaitingPath.empty(); }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Job> queue;
+    bool writing = false;
+    std::string awaitingPath;   // written to awaitingPath + ".tmp", waiting for poll() to rename
+    std::vector<Result> done;
+    bool stopping = false;
+    std::thread worker;
+};
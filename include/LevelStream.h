@@ -0,0 +1,42 @@
+#pragma once
+#include "ZipUtil.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Backing store for levels too large to keep resident. The archive holds the tiles
+// as fixed-size chunks (chunk_<cy>_<cx>.bin, CHUNK_ROWS x CHUNK_COLS bytes each);
+// Level keeps only the chunks around the camera in its grid window.
+class LevelStream {
+public:
+    static const int CHUNK_ROWS = 32;
+    static const int CHUNK_COLS = 32;
+    static const int CHUNK_TILES = CHUNK_ROWS * CHUNK_COLS;
+
+    LevelStream(ZipReader&& zip, const std::string& path, int rows, int cols);
+    // The archive is opened on the first chunk read (used by Level::snapshot).
+    LevelStream(const std::string& path, int rows, int cols);
+
+    static std::string chunkName(int cy, int cx);
+    static uint64_t chunkKey(int cy, int cx) { return ((uint64_t)(uint32_t)cy << 32) | (uint32_t)cx; }
+
+    // Tiles of one chunk; edited chunks that left the window come from the stash.
+    // Missing chunks read as empty.
+    void readChunk(int cy, int cx, uint8_t* out);
+    // Keeps an edited chunk that is leaving the window.
+    void stashChunk(int cy, int cx, const uint8_t* data);
+
+    // Re-opens the archive after it was rewritten in place.
+    bool reopen();
+
+    ZipReader zip;
+    std::string path;
+    int chunksY = 0, chunksX = 0;
+
+    // Resident window in chunk coordinates, [cy0, cy1) x [cx0, cx1)
+    int cy0 = 0, cy1 = 0, cx0 = 0, cx1 = 0;
+    std::unordered_set<uint64_t> dirty;  // window chunks edited since they were loaded
+    std::unordered_map<uint64_t, std::vector<uint8_t>> stash;
+};
@@ -5,17 +5,26 @@
 #include <vector>
 #include <string>
 
+class LevelManifest;
+class LevelPreloader;
+struct SaveData;
+
 class MainMenu {
 public:
-    MainMenu(SDL_Renderer* ren, const std::string& assetsDir, int maxLevel);
+    // Lists the levels in the manifest up to the one after the last completed one; the key
+    // opens all of them and the boss
+    MainMenu(SDL_Renderer* ren, const std::string& assetsDir, const LevelManifest& manifest, const SaveData& save,
+             LevelPreloader* preloader = nullptr);
     ~MainMenu();
-    int run(); // returns level 0-maxLevel, -1 for kill
+    int run(); // returns the chosen level number, -1 for kill
 
 private:
     SDL_Renderer* ren;
     std::vector<SDL_Texture*> textures;
+    std::vector<int> levels; // level number of each entry before mute, exit and kill
     int currentIndex;
     int maxLevel;
+    LevelPreloader* preloader;
 };
 
 #endif
@@ -7,7 +7,8 @@
 
 class Menu {
 public:
-    Menu(SDL_Renderer* renderer, const char* fontPath, int fontSize);
+    // font is shared (see FontCache) and must outlive the menu
+    Menu(SDL_Renderer* renderer, TTF_Font* font);
     ~Menu();
 
     void addItem(const std::string &label, std::function<void()> cb);
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "SolidBits.h"
+
+// Walking distances for one cell, in cells and capped at PatrolField::MAX_DIST.
+struct PatrolCell {
+    uint8_t edgeLeft;  // solid cells from here leftwards before the ground ends (0: no ground)
+    uint8_t edgeRight;
+    uint8_t wallLeft;  // cells from here to the nearest solid cell on the left (0: solid here)
+    uint8_t wallRight;
+};
+
+// Per-cell patrol data derived from SolidBits, so enemies decide where to turn with one
+// table read. Every value depends only on the cell's own row, which keeps edits cheap.
+// A walker in row r reads its ground from row r + 1 and its walls from row r.
+class PatrolField {
+public:
+    static constexpr int MAX_DIST = 255;
+
+    void rebuild(const SolidBits& solid);
+    // Call after the solidity of (r, c) changed; only the cells whose values change are touched.
+    void update(const SolidBits& solid, int r, int c);
+
+    PatrolCell at(int r, int c) const {
+        if ((unsigned)r >= (unsigned)rows || (unsigned)c >= (unsigned)cols) return { 0, 0, MAX_DIST, MAX_DIST };
+        return cells[(size_t)r * cols + c];
+    }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::vector<PatrolCell> cells;
+};
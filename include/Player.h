@@ -1,11 +1,13 @@
 #pragma once
 #include "Texture.h"
+#include "SpriteBatch.h"
 #include <vector>
 #include <SDL.h>
 
 class Player {
 public:
     float x = 100.f, y = 800.f;
+    float prevX = 100.f, prevY = 800.f; // position at the previous simulation step
     float vx = 0.f, vy = 0.f;
     bool onGround = false;
     std::vector<Texture*> frames;
@@ -22,5 +24,6 @@ public:
     float projectileCooldown = 0.0f;
 
     void update(double dt, const Uint8* kb);
-    void render(SDL_Renderer* r, int camX, int camY, float renderScale = 1.0f);
+    // alpha blends from the previous step's position (0) to the current one (1)
+    void render(SpriteBatch& batch, int camX, int camY, float renderScale = 1.0f, float alpha = 1.0f);
 };
\ No newline at end of file
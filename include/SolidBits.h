@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// One bit per solid tile, kept both per row and per column so span and column
+// queries scan 64 cells per word. Coordinates are relative to the grid it mirrors.
+class SolidBits {
+public:
+    // Sizes the sets for a rows x cols grid, all clear.
+    void reset(int rows, int cols);
+
+    void set(int r, int c, bool solid);
+    bool test(int r, int c) const {
+        return (unsigned)r < (unsigned)rows && (unsigned)c < (unsigned)cols &&
+               (rowBits[(size_t)r * rowWords + (c >> 6)] >> (c & 63)) & 1;
+    }
+
+    // First/last solid column of row r in [c0, c1], or -1.
+    int firstInRow(int r, int c0, int c1) const;
+    int lastInRow(int r, int c0, int c1) const;
+    // First solid row of column c in [r0, r1], or -1.
+    int firstInCol(int c, int r0, int r1) const;
+
+    int rowCount() const { return rows; }
+    int colCount() const { return cols; }
+
+private:
+    static int firstIn(const uint64_t* words, int lo, int hi);
+    static int lastIn(const uint64_t* words, int lo, int hi);
+
+    int rows = 0;
+    int cols = 0;
+    int rowWords = 0; // words per row in rowBits
+    int colWords = 0; // words per column in colBits
+    std::vector<uint64_t> rowBits;
+    std::vector<uint64_t> colBits;
+};
+
+inline int countTrailingZeros64(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+inline int countLeadingZeros64(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return 63 - (int)i;
+#else
+    return __builtin_clzll(v);
+#endif
+}
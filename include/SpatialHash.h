@@ -0,0 +1,92 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Uniform-grid broadphase for the moving things of one simulation step. Boxes are hashed
+// into every cell they cover, so a query only visits entries that share a cell with it;
+// the caller still runs its own exact test on each candidate.
+class SpatialHash {
+public:
+    enum Kind : uint8_t {
+        ENEMY = 1 << 0,
+        PROJECTILE = 1 << 1,
+        BOSS = 1 << 2,
+    };
+    static constexpr int KIND_COUNT = 3;
+
+    // cellSize in pixels; bucketCount is rounded up to a power of two
+    explicit SpatialHash(float cellSize = 64.0f, int bucketCount = 1024);
+
+    // Empties the hash; call once per step before inserting
+    void clear();
+    // index is the entry's position in its own container, handed back by query
+    void insert(Kind kind, int index, float left, float top, float w, float h);
+
+    // Calls fn(kind, index) once for every entry of the kinds in kindMask whose box touches
+    // (left, top, w, h). Entries come out in no particular order.
+    template <typename Fn>
+    void query(float left, float top, float w, float h, uint8_t kindMask, Fn fn);
+
+    size_t size() const { return items.size(); }
+
+private:
+    struct Item {
+        float left, top, right, bottom;
+        int index;
+        uint32_t stamp; // last query that reported this item
+        Kind kind;
+    };
+    struct Node {
+        int item;
+        int next; // next node in the same bucket, or -1
+    };
+
+    static int slotOf(Kind kind) {
+        int slot = 0;
+        while (!(kind & (1 << slot))) ++slot;
+        return slot;
+    }
+    int cellOf(float v) const { return (int)std::floor(v * invCellSize); }
+    size_t bucketOf(int cx, int cy) const {
+        return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & bucketMask;
+    }
+
+    float invCellSize;
+    size_t bucketMask;
+    uint32_t queryStamp = 0;
+    // First node of each bucket, or -1. Every kind has its own set of buckets so a query
+    // for enemies never walks past the projectiles that share their cells.
+    std::vector<int> heads[KIND_COUNT];
+    std::vector<Node> nodes;
+    std::vector<Item> items;
+};
+
+template <typename Fn>
+void SpatialHash::query(float left, float top, float w, float h, uint8_t kindMask, Fn fn) {
+    if (items.empty()) return;
+    if (++queryStamp == 0) {
+        // Wrapped around; old stamps could now match
+        for (auto& it : items) it.stamp = 0;
+        queryStamp = 1;
+    }
+    float right = left + w, bottom = top + h;
+    int cx0 = cellOf(left), cx1 = cellOf(right);
+    int cy0 = cellOf(top), cy1 = cellOf(bottom);
+    for (int slot = 0; slot < KIND_COUNT; ++slot) {
+        if (!(kindMask & (1 << slot))) continue;
+        const std::vector<int>& kindHeads = heads[slot];
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                for (int n = kindHeads[bucketOf(cx, cy)]; n >= 0; n = nodes[n].next) {
+                    Item& it = items[nodes[n].item];
+                    if (it.stamp == queryStamp) continue;
+                    // Different cells can share a bucket, so check the boxes really touch
+                    if (it.left > right || it.right < left || it.top > bottom || it.bottom < top) continue;
+                    it.stamp = queryStamp;
+                    fn(it.kind, it.index);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Texture.h"
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+// Packs the game's sprites into a few large textures at load time, so drawing a frame
+// switches textures a handful of times instead of once per sprite. The source images
+// are many times larger than they are drawn; scaleToHeight brings them down first,
+// normally on the preloader thread.
+class SpriteAtlas {
+public:
+    SpriteAtlas() = default;
+    ~SpriteAtlas();
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // An RGBA32 copy of src at most maxH pixels tall (box filtered), nullptr on failure.
+    // The caller owns the result. Safe to call off the main thread.
+    static SDL_Surface* scaleToHeight(SDL_Surface* src, int maxH, const std::string& name);
+
+    // Queues image for target as it is; it is read by build(), so the caller keeps it
+    // alive until then
+    void add(Texture& target, SDL_Surface* image, const std::string& name);
+    // Uploads the pages and points every queued Texture at its region. A sprite whose page
+    // can't be created gets a texture of its own. Returns false if any sprite failed.
+    bool build(SDL_Renderer* r);
+    // Frees the pages and empties the Textures still pointing into them, e.g. before the
+    // sprites are added and built again
+    void clear();
+
+private:
+    struct Entry {
+        Texture* target;
+        SDL_Surface* image; // the caller's, until build()
+        std::string name;
+        SDL_Rect rect;
+        int page;
+    };
+
+    // Transparent gap around each sprite so linear filtering never reads a neighbour
+    static const int PAD = 2;
+    static const int MAX_PAGE_SIZE = 2048;
+
+    std::vector<Entry> entries;
+    std::vector<SDL_Texture*> pages;
+    std::vector<Texture*> placed; // Textures given a region by build()
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include "Texture.h"
+#include <SDL.h>
+#include <cstddef>
+#include <vector>
+
+// Collects a frame's sprites and draws them with one SDL_RenderGeometry call per texture
+// instead of one copy per sprite. Quads outside the view are dropped when queued.
+// Textures are submitted in the order they were first used in the frame and quads keep
+// their order within a texture, so with everything in one atlas page nothing reorders.
+class SpriteBatch {
+public:
+    // Starts a frame; view is the visible area in render pixels
+    void begin(const SDL_Rect& view);
+    // Queues the src part of tex at dst. FLIP_HORIZONTAL mirrors it, tint multiplies it.
+    void draw(SDL_Texture* tex, const SDL_Rect& src, const SDL_Rect& dst,
+              SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color tint = { 255, 255, 255, 255 });
+    void draw(const Texture& tex, const SDL_Rect& dst,
+              SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color tint = { 255, 255, 255, 255 });
+    // Queues a solid rectangle, drawn with the renderer's blend mode
+    void fill(const SDL_Rect& dst, SDL_Color color);
+    // Draws everything queued since begin()
+    void flush(SDL_Renderer* r);
+
+    // Geometry calls made by the last flush, for the frame stats
+    size_t drawCalls() const { return lastDrawCalls; }
+
+private:
+    struct Quad {
+        int group; // index into groups, the quad's texture
+        SDL_Rect src, dst;
+        SDL_RendererFlip flip;
+        SDL_Color color;
+    };
+
+    void drawEach(SDL_Renderer* r, SDL_Texture* tex, size_t begin, size_t end);
+
+    SDL_Rect view{ 0, 0, 0, 0 };
+    std::vector<SDL_Texture*> groups; // textures by first use, nullptr for fills
+    std::vector<Quad> quads;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    size_t lastDrawCalls = 0;
+};
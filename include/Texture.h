@@ -6,8 +6,27 @@ class Texture {
 public:
     SDL_Texture* tex = nullptr;
     int w = 0, h = 0;
+    // Part of tex holding the image: all of it, or a region of a SpriteAtlas page
+    SDL_Rect src{ 0, 0, 0, 0 };
     Texture() = default;
     ~Texture();
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
     bool load(SDL_Renderer* r, const std::string& path);
+    // Decodes an encoded image (PNG/JPG) held in memory, e.g. an entry read from a level zip.
+    bool loadFromMemory(SDL_Renderer* r, const void* data, size_t size, const std::string& name);
+    // Uploads an already decoded surface; the surface stays owned by the caller.
+    bool loadFromSurface(SDL_Renderer* r, SDL_Surface* surf, const std::string& name);
+    // Shows a region of a texture owned elsewhere (an atlas page) instead of its own
+    void setRegion(SDL_Texture* page, const SDL_Rect& rect);
     void draw(SDL_Renderer* r, int x, int y, int w_ = -1, int h_ = -1);
-};
\ No newline at end of file
+
+    // CPU-side decode to RGBA32, safe to call off the render thread. Caller frees the surface.
+    static SDL_Surface* decodeFile(const std::string& path);
+    static SDL_Surface* decodeMemory(const void* data, size_t size, const std::string& name);
+
+private:
+    void release();
+    bool owned = false; // tex was created by this Texture
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include "Texture.h"
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Textures keyed by the hash of their encoded bytes, so an image shared by
+// several levels (e.g. the same background) is decoded and uploaded once.
+class TextureCache {
+public:
+    Texture* fromMemory(SDL_Renderer* r, const void* data, size_t size, const std::string& name);
+    Texture* fromFile(SDL_Renderer* r, const std::string& path);
+    // Uploads a surface decoded elsewhere (e.g. by LevelPreloader); key is the hash of its encoded bytes.
+    Texture* fromSurface(SDL_Renderer* r, uint64_t key, SDL_Surface* surf, const std::string& name);
+    void clear();
+
+private:
+    std::unordered_map<uint64_t, std::unique_ptr<Texture>> textures;
+};
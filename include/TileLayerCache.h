@@ -0,0 +1,58 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Level.h"
+#include "Texture.h"
+#include "Tiles.h"
+
+// The static tile layer pre-rendered into CHUNK_COLS x CHUNK_ROWS cell textures. A frame
+// only copies the few chunks under the view; a chunk is drawn again when setTile changes
+// one of its cells, and all of them when the level changes in bulk or edit mode toggles.
+// Without render target support the visible cells are drawn directly instead.
+class TileLayerCache {
+public:
+    static const int CHUNK_COLS = 16;
+    static const int CHUNK_ROWS = 16;
+    // Chunk textures kept around; the least recently drawn one is reused past this
+    static const int MAX_CHUNKS = 12;
+
+    TileLayerCache() = default;
+    ~TileLayerCache();
+    TileLayerCache(const TileLayerCache&) = delete;
+    TileLayerCache& operator=(const TileLayerCache&) = delete;
+
+    // tileTextures is indexed by Tiles::TextureId and must outlive the cache
+    void setTextures(const Texture* const* tileTextures);
+    // Frees every chunk texture, e.g. after the renderer lost its render targets
+    void clear();
+
+    // Draws the tiles under the view whose top-left corner is (camX, camY) in render pixels.
+    void render(SDL_Renderer* ren, Level& level, int camX, int camY, int viewW, int viewH,
+                int cellW, int cellH, bool editMode);
+
+private:
+    struct Chunk {
+        int cy, cx;
+        SDL_Texture* tex;
+        bool dirty;
+        uint32_t lastUsed;
+    };
+
+    Chunk* acquire(SDL_Renderer* ren, int cy, int cx);
+    void markDirty(int r, int c);
+    // Draws cells [r0, r1] x [c0, c1] with (r0, c0) at (originX, originY)
+    void drawCells(SDL_Renderer* ren, const Level& level, int r0, int r1, int c0, int c1,
+                   int originX, int originY, bool editMode) const;
+
+    const Texture* const* textures = nullptr;
+    SDL_Rect spriteRects[Tiles::TEX_COUNT] = {};
+    std::vector<Chunk> chunks;
+    std::vector<std::pair<int, int>> edits;
+    uint32_t revision = 0;
+    int cellW = 0, cellH = 0;
+    bool editMode = false;
+    bool valid = false; // revision, cell size and editMode describe the chunks
+    uint32_t frame = 0;
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include "Collision.h"
+#include "Tiles.h"
+#include <algorithm>
+#include <cmath>
+
+// One tile collision resolver for every kind of body, specialised at compile time by a
+// traits type. A body has float x (left), y (feet), prevX, prevY, vx, vy and int width,
+// height. The traits say which tiles it collides with and how it reacts:
+//
+//   struct ExampleTraits {
+//       static constexpr uint8_t SOLID = Tiles::F_SOLID; // tile flags that push the body out
+//       static constexpr bool PICKUPS = false;           // collect F_PICKUP tiles on touch
+//       static constexpr bool CONTACT = true;            // touching a tile face counts as a hit
+//       void onPickup(Body&, Level&, int r, int c, const Tiles::Info&);
+//       void onWall(Body&);                              // pushed out sideways
+//       void onLand(Body&);                              // came down on top of a tile
+//       void onTile(Body&, Level&, int r, int c, const Tiles::Info&); // after any push
+//       void afterResolve(Body&, Level&, int cellW, int cellH);
+//   };
+//
+// Hooks a body has no use for are left empty and vanish when inlined; onPickup is only
+// instantiated when PICKUPS is set.
+namespace Collision {
+    // Moves a box by (dx, dy), stopping at the tiles with any of the flags and sliding along
+    // them; onHit sees every tile it stops at. Three passes cover a hit on each axis plus a corner.
+    template <typename OnHit>
+    void slideBox(const Level& level, float& left, float& top, float w, float h, float dx, float dy,
+                  int cellW, int cellH, uint8_t flags, OnHit onHit) {
+        for (int pass = 0; pass < 3 && (dx != 0.0f || dy != 0.0f); ++pass) {
+            SweepHit hit = sweepTiles(level, left, top, w, h, dx, dy, cellW, cellH, flags);
+            left += dx * hit.t;
+            top += dy * hit.t;
+            if (!hit.hit) return;
+            dx *= 1.0f - hit.t;
+            dy *= 1.0f - hit.t;
+            if (hit.normalX != 0) dx = 0.0f;
+            else dy = 0.0f;
+            onHit(hit);
+        }
+    }
+
+    template <typename Traits, typename Body>
+    void resolveTiles(Traits& traits, Body& body, Level& level, int cellW, int cellH) {
+        if (cellW <= 0 || cellH <= 0) return;
+        if (level.rows <= 0 || level.cols <= 0) return;
+
+        const float eps = 0.0001f;
+        const float pw = static_cast<float>(body.width);
+        const float ph = static_cast<float>(body.height);
+
+        // Sweep the move made this step so a long step can't carry the body through a tile
+        {
+            float sweptLeft = body.prevX;
+            float sweptTop = body.prevY - ph;
+            slideBox(level, sweptLeft, sweptTop, pw, ph, body.x - body.prevX, body.y - body.prevY,
+                     cellW, cellH, Traits::SOLID, [&](const SweepHit& hit) {
+                         if (hit.normalX != 0) {
+                             traits.onWall(body);
+                         } else if (hit.normalY < 0) {
+                             traits.onLand(body);
+                         } else if (body.vy < 0.0f) {
+                             body.vy = 0.0f;
+                         }
+                         traits.onTile(body, level, hit.row, hit.col, Tiles::info(level.tile(hit.row, hit.col)));
+                     });
+            body.x = sweptLeft;
+            body.y = sweptTop + ph;
+        }
+
+        // Then push it out of anything it still overlaps. x is left, y is _feet_ (bottom).
+        float px = body.x;
+        float top = body.y - ph;
+
+        int minCol = (int)std::floor(px / cellW);
+        int maxCol = (int)std::floor((px + pw - eps) / cellW);
+        int minRow = (int)std::floor(top / cellH);
+        int maxRow = (int)std::floor((top + ph - eps) / cellH);
+
+        // Cells outside the resident window read as empty, so skip them
+        minCol = std::max(level.gridCol0, minCol);
+        minRow = std::max(level.gridRow0, minRow);
+        maxCol = std::min(level.gridCol0 + level.gridCols - 1, maxCol);
+        maxRow = std::min(level.gridRow0 + level.gridRows - 1, maxRow);
+
+        constexpr uint8_t touched = Traits::SOLID | (Traits::PICKUPS ? Tiles::F_PICKUP : 0);
+        for (int r = minRow; r <= maxRow; ++r) {
+            for (int c = minCol; c <= maxCol; ++c) {
+                const Tiles::Info& info = Tiles::info(level.tileUnchecked(r, c));
+                if (!(info.flags & touched)) continue;
+
+                float tx = static_cast<float>(c * cellW);
+                float ty = static_cast<float>(r * cellH);
+
+                float ix = std::min(px + pw, tx + cellW) - std::max(px, tx);
+                float iy = std::min(top + ph, ty + cellH) - std::max(top, ty);
+                if (ix <= 0.0f || (Traits::CONTACT ? iy < 0.0f : iy <= 0.0f)) continue;
+
+                if constexpr (Traits::PICKUPS) {
+                    if (info.flags & Tiles::F_PICKUP) {
+                        traits.onPickup(body, level, r, c, info);
+                        continue;
+                    }
+                }
+
+                // Resolve along smaller penetration
+                if (ix < iy) {
+                    // horizontal push
+                    if (px + pw * 0.5f < tx + cellW * 0.5f) px -= ix;
+                    else px += ix;
+                    body.x = px;
+                    traits.onWall(body);
+                } else {
+                    // vertical push
+                    if (top + ph * 0.5f < ty + cellH * 0.5f) {
+                        // collision from above -> place on top of tile
+                        top = ty - ph;
+                        traits.onLand(body);
+                    } else {
+                        // collision from below (head hit)
+                        top += iy;
+                        if (body.vy < 0.0f) body.vy = 0.0f;
+                    }
+                    body.y = top + ph;
+                }
+                traits.onTile(body, level, r, c, info);
+            }
+        }
+
+        body.x = px;
+        body.y = top + ph;
+        traits.afterResolve(body, level, cellW, cellH);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// What each tile value (0-255) stored in the level grid does and how it is drawn.
+// Collision, rendering and the editor look tiles up here instead of comparing values.
+namespace Tiles {
+
+enum Id : uint8_t {
+    EMPTY = 0,
+    SOLID = 1,
+    WATER = 2,       // damaging
+    PICKUP_5 = 3,
+    PICKUP_10 = 4,
+    ENEMY_SPAWN = 5,
+    PICKUP_15 = 6,
+    PICKUP_20 = 7,
+    HEAL = 8,
+    ROLLING = 9,     // heals and gives 5-10 points
+    KEY = 10,
+    KNOWN_COUNT = 11 // values past this are unknown and drawn as grey blocks
+};
+
+enum Flag : uint8_t {
+    F_BLOCKS = 1 << 0,       // pushes the player out
+    F_SOLID = 1 << 1,        // also blocks enemies and the boss
+    F_DAMAGING = 1 << 2,
+    F_PICKUP = 1 << 3,       // collected on touch
+    F_HEAL = 1 << 4,
+    F_KEY = 1 << 5,
+    F_RANDOM_SCORE = 1 << 6, // score plus 0-5 extra points
+};
+
+// Sprites used by tiles; main.cpp maps them to its loaded textures
+enum TextureId : uint8_t {
+    TEX_NONE,
+    TEX_WODA,
+    TEX_PIWO_1,
+    TEX_PIWO_2,
+    TEX_PIWO_KUFEL,
+    TEX_POLLITROKA,
+    TEX_PIWO_BUTELKA,
+    TEX_POLLITROWKA_3,
+    TEX_POLLITROWKA_2,
+    TEX_ZELAZO,
+    TEX_COUNT
+};
+
+enum Draw : uint8_t {
+    DRAW_NONE,
+    DRAW_FILL,        // solid colour rectangle over the cell
+    DRAW_EDITOR_FILL, // DRAW_FILL, only in edit mode
+    DRAW_SPRITE,      // texture scaled to the cell height and centred
+};
+
+struct Info {
+    uint8_t flags;
+    uint8_t score;
+    uint8_t draw;
+    uint8_t texture;
+    uint8_t altTexture; // used instead of texture on odd (row + col) cells
+    uint8_t r, g, b;    // DRAW_FILL colour
+    uint8_t editorNext; // value a click in the editor turns this tile into
+};
+
+constexpr Info sprite(uint8_t flags, uint8_t score, uint8_t texture, uint8_t editorNext) {
+    return { flags, score, DRAW_SPRITE, texture, texture, 0, 0, 0, editorNext };
+}
+
+constexpr std::array<Info, 256> makeTable() {
+    std::array<Info, 256> t{};
+    for (int v = 0; v < 256; ++v) {
+        // Unknown values block the player and cycle back into the known range in the editor
+        t[v] = { F_BLOCKS, 0, DRAW_FILL, TEX_NONE, TEX_NONE, 100, 100, 100, uint8_t((v + 1) % 6) };
+    }
+    t[EMPTY] = { 0, 0, DRAW_NONE, TEX_NONE, TEX_NONE, 0, 0, 0, SOLID };
+    t[SOLID] = { F_BLOCKS | F_SOLID, 0, DRAW_FILL, TEX_NONE, TEX_NONE, 128, 128, 128, WATER };
+    t[WATER] = sprite(F_BLOCKS | F_DAMAGING, 0, TEX_WODA, PICKUP_5);
+    t[PICKUP_5] = sprite(F_PICKUP, 5, TEX_PIWO_1, ENEMY_SPAWN);
+    t[PICKUP_10] = sprite(F_PICKUP, 10, TEX_PIWO_2, ENEMY_SPAWN);
+    t[ENEMY_SPAWN] = { 0, 0, DRAW_EDITOR_FILL, TEX_NONE, TEX_NONE, 255, 0, 0, HEAL };
+    t[PICKUP_15] = sprite(F_PICKUP, 15, TEX_PIWO_KUFEL, ENEMY_SPAWN);
+    t[PICKUP_20] = sprite(F_PICKUP, 20, TEX_POLLITROKA, ENEMY_SPAWN);
+    t[HEAL] = sprite(F_PICKUP | F_HEAL, 0, TEX_PIWO_BUTELKA, ROLLING);
+    t[ROLLING] = sprite(F_PICKUP | F_HEAL | F_RANDOM_SCORE, 5, TEX_POLLITROWKA_3, KEY);
+    t[ROLLING].altTexture = TEX_POLLITROWKA_2;
+    t[KEY] = sprite(F_PICKUP | F_KEY, 0, TEX_ZELAZO, EMPTY);
+    return t;
+}
+
+inline constexpr std::array<Info, 256> TABLE = makeTable();
+
+inline const Info& info(uint8_t value) { return TABLE[value]; }
+inline uint8_t flags(uint8_t value) { return TABLE[value].flags; }
+
+// The editor turns PICKUP_5 into any of the scored pickups
+inline constexpr uint8_t EDITOR_PICKUPS[4] = { PICKUP_5, PICKUP_10, PICKUP_15, PICKUP_20 };
+
+}
@@ -1,6 +1,80 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-bool saveLevelZip(const std::string& zipPath, const std::string& layout, const std::string& assets, const std::string& backgroundPath);
-bool loadLevelZip(const std::string& zipPath, std::string& layout, std::string& assets);
+// Entry names used inside a level archive
+constexpr const char* LAYOUT_BIN_ENTRY = "layout.bin";
+constexpr const char* LAYOUT_TXT_ENTRY = "layout.txt";
+constexpr const char* ASSETS_ENTRY = "assets.txt";
+
+// Sequentially writes a new zip archive (an existing file at the path is replaced).
+class ZipWriter {
+public:
+    ZipWriter() = default;
+    ~ZipWriter();
+    ZipWriter(const ZipWriter&) = delete;
+    ZipWriter& operator=(const ZipWriter&) = delete;
+
+    bool open(const std::string& path);
+    bool add(const std::string& name, const void* data, size_t size);
+    // Writes the central directory; false if any step failed.
+    bool close();
+
+private:
+    void* handle = nullptr;
+    bool ok = true;
+};
+
+// Writes a level archive. The background image is stored under backgroundName (skipped if
+// backgroundData is empty); writeExtra, if set, can append further entries (e.g. tile chunks)
+// before the archive is closed.
+bool saveLevelZip(const std::string& zipPath, const std::string& layoutName, const std::string& layout, const std::string& assets,
+                  const std::string& backgroundName, const std::vector<char>& backgroundData,
+                  const std::function<bool(ZipWriter&)>& writeExtra = nullptr);
+
+// Moves a finished file over target in one rename, so readers never see a partial file.
+// from is removed if the rename fails.
+bool replaceFile(const std::string& from, const std::string& target);
+
+// Read-only access to a zip archive. The central directory is walked once in open(),
+// after which entries are located by name without rescanning and inflated directly
+// into memory owned by the caller.
+class ZipReader {
+public:
+    ZipReader() = default;
+    ~ZipReader();
+    ZipReader(const ZipReader&) = delete;
+    ZipReader& operator=(const ZipReader&) = delete;
+    ZipReader(ZipReader&& other) noexcept;
+    ZipReader& operator=(ZipReader&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return handle != nullptr; }
+
+    bool has(const std::string& name) const;
+    // Uncompressed size of an entry, 0 if missing.
+    size_t entrySize(const std::string& name) const;
+    std::vector<std::string> entryNames() const;
+    // Byte offset of the entry's (compressed) data within the archive, 0 if missing.
+    uint64_t dataOffset(const std::string& name);
+
+    // Inflates the entry into dst, which must hold at least entrySize(name) bytes.
+    bool read(const std::string& name, char* dst, size_t capacity);
+    // Resizes out to the entry size and inflates into it (reuses out's capacity).
+    bool read(const std::string& name, std::vector<char>& out);
+
+private:
+    struct Entry {
+        unsigned long dirPos = 0;  // unz_file_pos
+        unsigned long fileNum = 0;
+        size_t size = 0;
+    };
+    void* handle = nullptr;
+    std::unordered_map<std::string, Entry> entries;
+};
@@ -24,6 +24,8 @@ void Boss::update(float dt, Player& player, std::vector<Projectile>& projectiles
         p.tex = &zelazo;
         p.x = x + width / 2.0f - p.width / 2.0f;
         p.y = y - height / 2.0f - p.height / 2.0f;
+        p.prevX = p.x;
+        p.prevY = p.y;
         float px = player.x + player.width / 2.0f;
         float py = player.y - player.height / 2.0f;
         float dx_attack = px - p.x;
@@ -58,13 +60,15 @@ void Boss::update(float dt, Player& player, std::vector<Projectile>& projectiles
     if (animationTimer >= 1.0f) animationTimer = 0.0f;
 }
 
-void Boss::render(SDL_Renderer* ren, int camX, int camY, float scale) {
+void Boss::render(SpriteBatch& batch, int camX, int camY, float scale, float alpha) {
     if (isMoving) {
         currentFrame = (int)(animationTimer * 5.0f) % frames.size();
     }
     int frame = currentFrame;
     if (frames[frame] && frames[frame]->tex) {
-        SDL_Rect dst = { (int)((x - camX) * scale), (int)((y - height - camY) * scale), (int)(width * scale), (int)(height * scale) };
-        SDL_RenderCopyEx(ren, frames[frame]->tex, nullptr, &dst, 0.0, nullptr, facingLeft ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL);
+        float drawX = prevX + (x - prevX) * alpha;
+        float drawY = prevY + (y - prevY) * alpha;
+        SDL_Rect dst = { (int)((drawX - camX) * scale), (int)((drawY - height - camY) * scale), (int)(width * scale), (int)(height * scale) };
+        batch.draw(*frames[frame], dst, facingLeft ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL);
     }
 }
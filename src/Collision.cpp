@@ -1,259 +1,182 @@
 ﻿#include "Collision.h"
+#include "TileResolver.h"
+#include "Tiles.h"
 #include <algorithm>
 #include <cmath>
-#include <SDL_mixer.h>
-
-extern Mix_Chunk* globalPickSound;
+#include <cstdlib>
+#include <limits>
 
 namespace Collision {
-    void resolvePlayerCollisions(Player& player, Level& level, int cellW, int cellH, SaveData& saveData) {
-        if (cellW <= 0 || cellH <= 0) return;
-        if (level.rows <= 0 || level.cols <= 0) return;
-
-        const float eps = 0.0001f;
-
-        // Physics: player.x is left, player.y is _feet_ (bottom).
-        float px = player.x;
-        float pw = static_cast<float>(player.width);
-        float top = player.y - static_cast<float>(player.height);
-        float ph = static_cast<float>(player.height);
+    // Boxes closer than this count as touching, not overlapping, so resting bodies don't snag
+    static const float SWEEP_EPS = 0.001f;
+
+    bool sweepBox(float aLeft, float aTop, float aw, float ah, float dx, float dy,
+                  float bLeft, float bTop, float bw, float bh, float& t, int& normalX, int& normalY) {
+        const float inf = std::numeric_limits<float>::infinity();
+        bool overlapX = aLeft < bLeft + bw - SWEEP_EPS && aLeft + aw > bLeft + SWEEP_EPS;
+        bool overlapY = aTop < bTop + bh - SWEEP_EPS && aTop + ah > bTop + SWEEP_EPS;
+        if (overlapX && overlapY) return false;
+
+        // Times the box enters and leaves b's slab on each axis
+        float xEntry, xExit, yEntry, yExit;
+        if (dx > 0.0f) { xEntry = (bLeft - (aLeft + aw)) / dx; xExit = (bLeft + bw - aLeft) / dx; }
+        else if (dx < 0.0f) { xEntry = (bLeft + bw - aLeft) / dx; xExit = (bLeft - (aLeft + aw)) / dx; }
+        else if (overlapX) { xEntry = -inf; xExit = inf; }
+        else return false;
+        if (dy > 0.0f) { yEntry = (bTop - (aTop + ah)) / dy; yExit = (bTop + bh - aTop) / dy; }
+        else if (dy < 0.0f) { yEntry = (bTop + bh - aTop) / dy; yExit = (bTop - (aTop + ah)) / dy; }
+        else if (overlapY) { yEntry = -inf; yExit = inf; }
+        else return false;
+
+        float entry = std::max(xEntry, yEntry);
+        float exit = std::min(xExit, yExit);
+        if (entry > exit || entry > 1.0f || exit <= 0.0f) return false;
+        // A negative entry is only a touching contact if it is within SWEEP_EPS
+        if (entry < 0.0f && (xEntry > yEntry ? xEntry * std::fabs(dx) : yEntry * std::fabs(dy)) < -SWEEP_EPS) return false;
+
+        t = std::max(0.0f, entry);
+        if (xEntry > yEntry) { normalX = dx > 0.0f ? -1 : 1; normalY = 0; }
+        else { normalX = 0; normalY = dy > 0.0f ? -1 : 1; }
+        return true;
+    }
 
-        int minCol = (int)std::floor(px / cellW);
-        int maxCol = (int)std::floor((px + pw - eps) / cellW);
-        int minRow = (int)std::floor(top / cellH);
-        int maxRow = (int)std::floor((top + ph - eps) / cellH);
+    bool sweptOverlap(float fromLeft, float fromTop, float toLeft, float toTop, float aw, float ah,
+                      float bLeft, float bTop, float bw, float bh) {
+        auto overlaps = [&](float l, float t) { return l < bLeft + bw && l + aw > bLeft && t < bTop + bh && t + ah > bTop; };
+        if (overlaps(toLeft, toTop) || overlaps(fromLeft, fromTop)) return true;
+        float t;
+        int nx, ny;
+        return sweepBox(fromLeft, fromTop, aw, ah, toLeft - fromLeft, toTop - fromTop, bLeft, bTop, bw, bh, t, nx, ny);
+    }
 
-        minCol = std::max(0, minCol);
-        minRow = std::max(0, minRow);
-        maxCol = std::min(level.cols - 1, maxCol);
-        maxRow = std::min(level.rows - 1, maxRow);
+    SweepHit sweepTiles(const Level& level, float left, float top, float w, float h, float dx, float dy,
+                        int cellW, int cellH, uint8_t flags) {
+        SweepHit best;
+        if (cellW <= 0 || cellH <= 0 || (dx == 0.0f && dy == 0.0f)) return best;
+
+        // Only the cells under the swept bounds can be hit
+        int minCol = (int)std::floor(std::min(left, left + dx) / cellW);
+        int maxCol = (int)std::floor((std::max(left, left + dx) + w - SWEEP_EPS) / cellW);
+        int minRow = (int)std::floor(std::min(top, top + dy) / cellH);
+        int maxRow = (int)std::floor((std::max(top, top + dy) + h - SWEEP_EPS) / cellH);
+        minCol = std::max(level.gridCol0, minCol);
+        minRow = std::max(level.gridRow0, minRow);
+        maxCol = std::min(level.gridCol0 + level.gridCols - 1, maxCol);
+        maxRow = std::min(level.gridRow0 + level.gridRows - 1, maxRow);
 
         for (int r = minRow; r <= maxRow; ++r) {
-            if (r < 0 || r >= (int)level.grid.size()) continue;
             for (int c = minCol; c <= maxCol; ++c) {
-                if (c < 0 || c >= (int)level.grid[r].size()) continue;
-
-                int cell = level.grid[r][c]; // 0=empty,1=solid,2=damaging,3=pickup,4=pickup,5=enemy spawn,6=pickup,7=pickup,8=heal,9=rolling pickup
-                if (cell == 0 || cell == 5) continue; // non-solid and ignore enemy spawn markers
-
-                float tx = static_cast<float>(c * cellW);
-                float ty = static_cast<float>(r * cellH);
-
-                float ix = std::min(px + pw, tx + cellW) - std::max(px, tx);
-                float iy = std::min(top + ph, ty + cellH) - std::max(top, ty);
-
-                if (ix > 0.0f && iy > 0.0f) {
-                    if (cell == 3 || cell == 4 || cell == 6 || cell == 7 || cell == 8 || cell == 9 || cell == 10) {
-                        if (cell == 8) {
-                            player.health += 1;
-                        } else if (cell == 9) {
-                            player.health += 1;
-                            int points = 5 + rand() % 6; // 5 to 10
-                            player.score += points;
-                        } else if (cell == 10) {
-                            saveData.hasKey = true;
-                            saveProgress(saveData);
-                        } else {
-                            int points = 5;
-                            if (cell == 4) points = 10;
-                            else if (cell == 6) points = 15;
-                            else if (cell == 7) points = 20;
-                            player.score += points;
-                        }
-                        level.grid[r][c] = 0; // remove pickup
-                        if (globalPickSound) Mix_PlayChannel(-1, globalPickSound, 0);
-                        continue;
-                    }
-
-                    bool isDamaging = (cell == 2);
-
-                    // Resolve along smaller penetration (push player out)
-                    if (ix < iy) {
-                        // horizontal push
-                        if (px + pw * 0.5f < tx + cellW * 0.5f) {
-                            // push left
-                            px -= ix;
-                        } else {
-                            // push right
-                            px += ix;
-                        }
-                        // apply horizontal correction
-                        player.x = px;
-                    } else {
-                        // vertical push
-                        if (top + ph * 0.5f < ty + cellH * 0.5f) {
-                            // collision from above -> place player on top of tile
-                            top = ty - ph;
-                            player.vy = 0.0f;
-                            player.onGround = true;
-                        } else {
-                            // collision from below -> push player down (head hit)
-                            top += iy;
-                            if (player.vy < 0.0f) player.vy = 0.0f;
-                        }
-                        // apply vertical correction
-                        player.y = top + ph;
-                    }
-
-                    // Handle damage
-                    if (isDamaging && player.invulnTimer <= 0.0f) {
-                        player.health -= 1;
-                        player.invulnTimer = player.invuln;
-                        if (player.health < 0) player.health = 0;
-                        level.grid[r][c] = 0; // remove damaging pickup
-                    }
+                if (!(Tiles::flags(level.tileUnchecked(r, c)) & flags)) continue;
+                float t;
+                int nx, ny;
+                if (sweepBox(left, top, w, h, dx, dy, (float)(c * cellW), (float)(r * cellH), (float)cellW, (float)cellH, t, nx, ny) &&
+                    t < best.t) {
+                    best.hit = true;
+                    best.t = t;
+                    best.normalX = nx;
+                    best.normalY = ny;
+                    best.row = r;
+                    best.col = c;
                 }
             }
         }
-
-        // Ensure the resolved values are applied
-        player.x = px;
-        player.y = top + ph;
+        return best;
     }
 
-    void resolveEnemyCollisions(Enemy& enemy, Level& level, int cellW, int cellH) {
-        if (cellW <= 0 || cellH <= 0) return;
-        if (level.rows <= 0 || level.cols <= 0) return;
-
-        const float eps = 0.0001f;
-
-        // Enemy physics: enemy.x is left, enemy.y is _feet_ (bottom).
-        float px = enemy.x;
-        float pw = static_cast<float>(enemy.width);
-        float top = enemy.y - static_cast<float>(enemy.height);
-        float ph = static_cast<float>(enemy.height);
-
-        int minCol = (int)std::floor(px / cellW);
-        int maxCol = (int)std::floor((px + pw - eps) / cellW);
-        int minRow = (int)std::floor(top / cellH);
-        int maxRow = (int)std::floor((top + ph - eps) / cellH);
-
-        minCol = std::max(0, minCol);
-        minRow = std::max(0, minRow);
-        maxCol = std::min(level.cols - 1, maxCol);
-        maxRow = std::min(level.rows - 1, maxRow);
-
-        for (int r = minRow; r <= maxRow; ++r) {
-            if (r < 0 || r >= (int)level.grid.size()) continue;
-            for (int c = minCol; c <= maxCol; ++c) {
-                if (c < 0 || c >= (int)level.grid[r].size()) continue;
-
-                int cell = level.grid[r][c]; // 0=empty,1=solid,2=damaging,3=pickup
-                if (cell != 1) continue; // only solid for enemy
-
-                float tx = static_cast<float>(c * cellW);
-                float ty = static_cast<float>(r * cellH);
+    // Per-body collision rules for resolveTiles (see TileResolver.h)
+
+    struct PlayerTraits {
+        static constexpr uint8_t SOLID = Tiles::F_BLOCKS;
+        static constexpr bool PICKUPS = true;
+        static constexpr bool CONTACT = false;
+        EventQueue& events;
+
+        void onPickup(Player& player, Level& level, int r, int c, const Tiles::Info& info) {
+            if (info.flags & Tiles::F_HEAL) player.health += 1;
+            Event picked{ Event::PICKUP, r, c };
+            picked.points = info.score;
+            if (info.flags & Tiles::F_RANDOM_SCORE) picked.points += rand() % 6; // 5 to 10
+            events.push(picked);
+            if (info.flags & Tiles::F_KEY) events.push({ Event::KEY, r, c });
+            level.setTile(r, c, 0); // remove pickup
+        }
+        void onWall(Player&) {}
+        void onLand(Player& player) {
+            player.vy = 0.0f;
+            player.onGround = true;
+        }
+        void onTile(Player& player, Level& level, int r, int c, const Tiles::Info& info) {
+            if (!(info.flags & Tiles::F_DAMAGING) || player.invulnTimer > 0.0f) return;
+            player.health -= 1;
+            player.invulnTimer = player.invuln;
+            if (player.health < 0) player.health = 0;
+            events.push({ Event::DAMAGE, r, c });
+            level.setTile(r, c, 0); // remove damaging pickup
+        }
+        void afterResolve(Player&, Level&, int, int) {}
+    };
 
-                float ix = std::min(px + pw, tx + cellW) - std::max(px, tx);
-                float iy = std::min(top + ph, ty + cellH) - std::max(top, ty);
+    struct EnemyTraits {
+        static constexpr uint8_t SOLID = Tiles::F_SOLID;
+        static constexpr bool PICKUPS = false;
+        static constexpr bool CONTACT = true; // standing exactly on a tile keeps it on the ground
 
-                if (ix > 0.0f && iy >= 0.0f) {
-                    // Resolve along smaller penetration
-                    if (ix < iy) {
-                        // horizontal push
-                        if (px + pw * 0.5f < tx + cellW * 0.5f) {
-                            // push left
-                            px -= ix;
-                        } else {
-                            // push right
-                            px += ix;
-                        }
-                        // apply immediate horizontal correction
-                        enemy.x = px;
-                        enemy.vx = -enemy.vx; // reverse direction on collision
-                        if (enemy.vx < 0) enemy.facingLeft = false;
-                        else enemy.facingLeft = true;
-                    } else {
-                        // vertical push
-                        if (top + ph * 0.5f < ty + cellH * 0.5f) {
-                            // collision from above -> place on top
-                            top = ty - ph;
-                            enemy.vy = 0.0f;
-                            enemy.onGround = true;
-                        } else {
-                            // collision from below
-                            top += iy;
-                            if (enemy.vy < 0.0f) enemy.vy = 0.0f;
-                        }
-                        enemy.y = top + ph;
-                    }
-                }
-            }
+        void onWall(Enemy& enemy) {
+            enemy.vx = -enemy.vx; // reverse direction on collision
+            enemy.facingLeft = enemy.vx >= 0;
         }
-
-        // Prevent falling off edges
-        if (enemy.onGround && fabs(enemy.vx) > 0.1f) {
-            int dir = enemy.vx > 0 ? 1 : -1;
-            int checkC = dir > 0 ? (int)std::floor((enemy.x + enemy.width) / cellW) : (int)std::floor(enemy.x / cellW);
-            int checkR = (int)std::floor((enemy.y + 1) / cellH);
-            if (checkC >= 0 && checkC < level.cols && checkR >= 0 && checkR < level.rows) {
-                if (level.grid[checkR][checkC] != 1) {
-                    enemy.vx = -enemy.vx;
-                    if (enemy.vx < 0) enemy.facingLeft = false;
-                    else enemy.facingLeft = true;
-                }
+        void onLand(Enemy& enemy) {
+            enemy.vy = 0.0f;
+            enemy.onGround = true;
+        }
+        void onTile(Enemy&, Level&, int, int, const Tiles::Info&) {}
+
+        // Turn once the leading edge reaches the end of the ground below or a wall in the
+        // body's row, both read as distances from the cell under the leading edge
+        void afterResolve(Enemy& enemy, Level& level, int cellW, int cellH) {
+            if (!enemy.onGround || fabs(enemy.vx) <= 0.1f) return;
+            const bool right = enemy.vx > 0;
+            const float lead = right ? enemy.x + enemy.width : enemy.x;
+            const int leadC = (int)std::floor((right ? lead - 0.001f : lead) / cellW);
+            const int groundR = (int)std::floor((enemy.y + 1) / cellH);
+            const int bodyR = (int)std::floor((enemy.y - 1) / cellH);
+            if (leadC < 0 || leadC >= level.cols || groundR < 0 || groundR >= level.rows) return;
+
+            PatrolCell ground = level.patrolAt(groundR, leadC);
+            PatrolCell body = level.patrolAt(bodyR, leadC);
+            if (right) {
+                int stopC = leadC + std::min<int>(ground.edgeRight, body.wallRight);
+                if (lead >= (float)stopC * cellW) onWall(enemy);
+            } else {
+                int stopC = leadC - std::min<int>(ground.edgeLeft, body.wallLeft) + 1;
+                if (lead <= (float)stopC * cellW) onWall(enemy);
             }
         }
+    };
+
+    struct BossTraits {
+        static constexpr uint8_t SOLID = Tiles::F_SOLID;
+        static constexpr bool PICKUPS = false;
+        static constexpr bool CONTACT = true;
+
+        void onWall(Boss& boss) { boss.vx = -boss.vx; }
+        void onLand(Boss& boss) { boss.vy = 0.0f; }
+        void onTile(Boss&, Level&, int, int, const Tiles::Info&) {}
+        void afterResolve(Boss&, Level&, int, int) {}
+    };
+
+    void resolvePlayerCollisions(Player& player, Level& level, int cellW, int cellH, EventQueue& events) {
+        PlayerTraits traits{ events };
+        resolveTiles(traits, player, level, cellW, cellH);
     }
 
-    void resolveBossCollisions(Boss& boss, Level& level, int cellW, int cellH) {
-        if (cellW <= 0 || cellH <= 0) return;
-        if (level.rows <= 0 || level.cols <= 0) return;
-
-        const float eps = 0.0001f;
-
-        float px = boss.x;
-        float pw = static_cast<float>(boss.width);
-        float top = boss.y - static_cast<float>(boss.height);
-        float ph = static_cast<float>(boss.height);
-
-        int minCol = (int)std::floor(px / cellW);
-        int maxCol = (int)std::floor((px + pw - eps) / cellW);
-        int minRow = (int)std::floor(top / cellH);
-        int maxRow = (int)std::floor((top + ph - eps) / cellH);
-
-        minCol = std::max(0, minCol);
-        minRow = std::max(0, minRow);
-        maxCol = std::min(level.cols - 1, maxCol);
-        maxRow = std::min(level.rows - 1, maxRow);
-
-        for (int r = minRow; r <= maxRow; ++r) {
-            if (r < 0 || r >= (int)level.grid.size()) continue;
-            for (int c = minCol; c <= maxCol; ++c) {
-                if (c < 0 || c >= (int)level.grid[r].size()) continue;
-
-                int cell = level.grid[r][c];
-                if (cell != 1) continue; // only solid
-
-                float tx = static_cast<float>(c * cellW);
-                float ty = static_cast<float>(r * cellH);
-
-                float ix = std::min(px + pw, tx + cellW) - std::max(px, tx);
-                float iy = std::min(top + ph, ty + cellH) - std::max(top, ty);
+    void resolveEnemyCollisions(Enemy& enemy, Level& level, int cellW, int cellH) {
+        EnemyTraits traits;
+        resolveTiles(traits, enemy, level, cellW, cellH);
+    }
 
-                if (ix > 0.0f && iy >= 0.0f) {
-                    if (ix < iy) {
-                        if (px + pw * 0.5f < tx + cellW * 0.5f) {
-                            px -= ix;
-                        } else {
-                            px += ix;
-                        }
-                        boss.x = px;
-                        boss.vx = -boss.vx;
-                    } else {
-                        if (top + ph * 0.5f < ty + cellH * 0.5f) {
-                            // collision from above -> place on top
-                            top = ty - ph;
-                            boss.vy = 0.0f;
-                        } else {
-                            // collision from below
-                            top += iy;
-                            if (boss.vy < 0.0f) boss.vy = 0.0f;
-                        }
-                        boss.y = top + ph;
-                    }
-                }
-            }
-        }
+    void resolveBossCollisions(Boss& boss, Level& level, int cellW, int cellH) {
+        BossTraits traits;
+        resolveTiles(traits, boss, level, cellW, cellH);
     }
 }
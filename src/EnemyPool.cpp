@@ -0,0 +1,260 @@
+#include "EnemyPool.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENEMY_POOL_SSE2 1
+#endif
+
+static const float GRAVITY = 1200.f;
+
+void EnemyPool::clear() {
+    x.clear(); y.clear();
+    prevX.clear(); prevY.clear();
+    vx.clear(); vy.clear();
+    frameTime.clear();
+    frame.clear();
+    flags.clear();
+    awake.clear();
+}
+
+void EnemyPool::spawn(float left, float feet, float speed) {
+    x.push_back(left); y.push_back(feet);
+    prevX.push_back(left); prevY.push_back(feet);
+    vx.push_back(speed); vy.push_back(0.0f);
+    frameTime.push_back(0.0);
+    frame.push_back(0);
+    flags.push_back(ON_GROUND);
+    awake.push_back(1);
+}
+
+void EnemyPool::swapGuards(size_t a, size_t b) {
+    std::swap(x[a], x[b]); std::swap(y[a], y[b]);
+    std::swap(prevX[a], prevX[b]); std::swap(prevY[a], prevY[b]);
+    std::swap(vx[a], vx[b]); std::swap(vy[a], vy[b]);
+    std::swap(frameTime[a], frameTime[b]);
+    std::swap(frame[a], frame[b]);
+    std::swap(flags[a], flags[b]);
+    std::swap(awake[a], awake[b]);
+}
+
+template <typename T>
+static void applyOrder(std::vector<T>& v, const std::vector<size_t>& order) {
+    std::vector<T> sorted;
+    sorted.reserve(v.size());
+    for (size_t i : order) sorted.push_back(v[i]);
+    v.swap(sorted);
+}
+
+void EnemyPool::sortByX() {
+    std::vector<size_t> order(size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return x[a] < x[b]; });
+    applyOrder(x, order); applyOrder(y, order);
+    applyOrder(prevX, order); applyOrder(prevY, order);
+    applyOrder(vx, order); applyOrder(vy, order);
+    applyOrder(frameTime, order);
+    applyOrder(frame, order);
+    applyOrder(flags, order);
+    applyOrder(awake, order);
+}
+
+void EnemyPool::restoreOrder(size_t begin, size_t end) {
+    // Insertion sort: everything before begin is still in order, so each moved guard only
+    // walks as far as it overtook others. Guards after end are in order among themselves,
+    // so once one of them is in place the rest are too.
+    const size_t n = size();
+    for (size_t i = begin; i < n; ++i) {
+        if (i >= end && (i == 0 || x[i - 1] <= x[i])) break;
+        for (size_t j = i; j > 0 && x[j - 1] > x[j]; --j) swapGuards(j - 1, j);
+    }
+}
+
+size_t EnemyPool::lowerBound(float left) const {
+    return std::lower_bound(x.begin(), x.end(), left) - x.begin();
+}
+
+size_t EnemyPool::upperBound(float right) const {
+    return std::upper_bound(x.begin(), x.end(), right) - x.begin();
+}
+
+void EnemyPool::kill(size_t i) {
+    flags[i] |= DEAD;
+    frame[i] = 0;
+    frameTime[i] = 0.0;
+}
+
+void EnemyPool::removeInactive() {
+    size_t out = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        if (flags[i] & INACTIVE) continue;
+        if (out != i) {
+            x[out] = x[i]; y[out] = y[i];
+            prevX[out] = prevX[i]; prevY[out] = prevY[i];
+            vx[out] = vx[i]; vy[out] = vy[i];
+            frameTime[out] = frameTime[i];
+            frame[out] = frame[i];
+            flags[out] = flags[i];
+            awake[out] = awake[i];
+        }
+        ++out;
+    }
+    if (out == size()) return;
+    x.resize(out); y.resize(out);
+    prevX.resize(out); prevY.resize(out);
+    vx.resize(out); vy.resize(out);
+    frameTime.resize(out);
+    frame.resize(out);
+    flags.resize(out);
+    awake.resize(out);
+}
+
+void EnemyPool::savePrevious(size_t begin, size_t end) {
+    std::copy(x.begin() + begin, x.begin() + end, prevX.begin() + begin);
+    std::copy(y.begin() + begin, y.begin() + end, prevY.begin() + begin);
+}
+
+// Patrol motion and gravity for guards [begin, end), the scalar twin of the SIMD loop
+void EnemyPool::integrate(size_t begin, size_t end, float dt, float levelWidth) {
+    const float w = (float)width;
+    for (size_t i = begin; i < end; ++i) {
+        if (!awake[i] || (flags[i] & DEAD)) continue;
+        float nx = x[i] + vx[i] * dt;
+        if (nx <= 0) {
+            nx = 0;
+            vx[i] = -vx[i];
+        } else if (nx + w >= levelWidth) {
+            nx = levelWidth - w;
+            vx[i] = -vx[i];
+        }
+        x[i] = nx;
+        vy[i] += GRAVITY * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+void EnemyPool::update(double stepDt, int levelWidth, size_t begin, size_t end) {
+    const float dt = (float)stepDt;
+    const size_t n = std::min(end, size());
+    size_t i = begin;
+
+#ifdef ENEMY_POOL_SSE2
+    // Four guards per iteration; lanes that don't move keep their old values
+    const __m128 dtv = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 wv = _mm_set1_ps((float)width);
+    const __m128 levelWv = _mm_set1_ps((float)levelWidth);
+    const __m128 rightStop = _mm_set1_ps((float)levelWidth - (float)width);
+    const __m128 gdt = _mm_set1_ps(GRAVITY * dt);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i deadBit = _mm_set1_epi32(DEAD);
+    auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+    auto widen = [&](const uint8_t* p) {
+        int v;
+        std::copy(p, p + 4, reinterpret_cast<uint8_t*>(&v));
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zeroi), zeroi);
+    };
+    for (; i + 4 <= n; i += 4) {
+        __m128i aw = widen(&awake[i]);
+        __m128i fl = widen(&flags[i]);
+        __m128 move = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(aw, zeroi),
+                                                        _mm_cmpeq_epi32(_mm_and_si128(fl, deadBit), zeroi)));
+
+        __m128 xv = _mm_loadu_ps(&x[i]);
+        __m128 vxv = _mm_loadu_ps(&vx[i]);
+        __m128 nx = _mm_add_ps(xv, _mm_mul_ps(vxv, dtv));
+        __m128 hitLeft = _mm_cmple_ps(nx, zero);
+        __m128 hitRight = _mm_andnot_ps(hitLeft, _mm_cmpge_ps(_mm_add_ps(nx, wv), levelWv));
+        nx = select(hitLeft, zero, select(hitRight, rightStop, nx));
+        __m128 nvx = select(_mm_or_ps(hitLeft, hitRight), _mm_xor_ps(vxv, signBit), vxv);
+
+        __m128 yv = _mm_loadu_ps(&y[i]);
+        __m128 vyv = _mm_loadu_ps(&vy[i]);
+        __m128 nvy = _mm_add_ps(vyv, gdt);
+        __m128 ny = _mm_add_ps(yv, _mm_mul_ps(nvy, dtv));
+
+        _mm_storeu_ps(&x[i], select(move, nx, xv));
+        _mm_storeu_ps(&vx[i], select(move, nvx, vxv));
+        _mm_storeu_ps(&y[i], select(move, ny, yv));
+        _mm_storeu_ps(&vy[i], select(move, nvy, vyv));
+    }
+#endif
+    integrate(i, n, dt, (float)levelWidth);
+
+    // Facing and animation are per-guard branches, cheap next to the motion above
+    const int frameCount = (int)frames.size();
+    const double stepMs = stepDt * 1000.0;
+    for (size_t j = begin; j < n; ++j) {
+        if (!awake[j]) continue;
+        uint8_t& f = flags[j];
+        if (f & DEAD) {
+            if (frameCount == 0) continue;
+            frameTime[j] += stepMs;
+            if (frameTime[j] >= frameDelay) {
+                frameTime[j] = 0.0;
+                if (++frame[j] >= frameCount) f |= INACTIVE;
+            }
+            continue;
+        }
+
+        bool facingLeft = (f & FACING_LEFT) != 0;
+        if (vx[j] > 0) facingLeft = true;
+        else if (vx[j] < 0) facingLeft = false;
+        else if (x[j] <= 0) facingLeft = true;
+        else if (x[j] + width >= levelWidth) facingLeft = false;
+        f = facingLeft ? (f | FACING_LEFT) : (f & ~FACING_LEFT);
+
+        if (frameCount == 0) {
+            frame[j] = 0;
+            frameTime[j] = 0.0;
+            continue;
+        }
+        frameTime[j] += stepMs;
+        if (frameTime[j] >= frameDelay) {
+            frame[j] = (uint8_t)((frame[j] + 1) % frameCount);
+            frameTime[j] = 0.0;
+        }
+    }
+}
+
+Enemy EnemyPool::body(size_t i) const {
+    Enemy e;
+    e.x = x[i]; e.y = y[i];
+    e.prevX = prevX[i]; e.prevY = prevY[i];
+    e.vx = vx[i]; e.vy = vy[i];
+    e.onGround = (flags[i] & ON_GROUND) != 0;
+    e.facingLeft = (flags[i] & FACING_LEFT) != 0;
+    e.width = width;
+    e.height = height;
+    return e;
+}
+
+void EnemyPool::setBody(size_t i, const Enemy& e) {
+    x[i] = e.x; y[i] = e.y;
+    vx[i] = e.vx; vy[i] = e.vy;
+    uint8_t f = flags[i] & ~(ON_GROUND | FACING_LEFT);
+    if (e.onGround) f |= ON_GROUND;
+    if (e.facingLeft) f |= FACING_LEFT;
+    flags[i] = f;
+}
+
+void EnemyPool::render(SpriteBatch& batch, int camX, int camY, float renderScale, float alpha, size_t begin, size_t end) const {
+    if (frames.empty()) return;
+
+    for (size_t i = begin; i < std::min(end, size()); ++i) {
+        float drawX = prevX[i] + (x[i] - prevX[i]) * alpha;
+        float drawY = prevY[i] + (y[i] - prevY[i]) * alpha;
+        SDL_Rect dst{
+            static_cast<int>((drawX - camX) * renderScale),
+            static_cast<int>((drawY - height - camY) * renderScale),
+            static_cast<int>(width * renderScale),
+            static_cast<int>(height * renderScale)
+        };
+
+        Texture* tex = frames[std::min<size_t>(frame[i], frames.size() - 1)];
+        if (tex && tex->tex) {
+            batch.draw(*tex, dst, (flags[i] & FACING_LEFT) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+        }
+    }
+}
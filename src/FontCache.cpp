@@ -0,0 +1,25 @@
+#include "FontCache.h"
+
+FontCache::~FontCache() {
+    clear();
+}
+
+TTF_Font* FontCache::get(const std::string& path, int size) {
+    auto key = std::make_pair(path, size);
+    auto it = fonts.find(key);
+    if (it != fonts.end()) return it->second;
+
+    TTF_Font* font = TTF_OpenFont(path.c_str(), size);
+    if (!font) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "TTF_OpenFont failed for %s: %s", path.c_str(), TTF_GetError());
+    }
+    fonts[key] = font;
+    return font;
+}
+
+void FontCache::clear() {
+    for (auto& entry : fonts) {
+        if (entry.second) TTF_CloseFont(entry.second);
+    }
+    fonts.clear();
+}
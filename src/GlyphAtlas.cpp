@@ -0,0 +1,112 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <vector>
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer* r, TTF_Font* f) : ren(r), font(f) {
+    if (!ren || !font) return;
+    height = TTF_FontHeight(font);
+    tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, SIZE, SIZE);
+    if (!tex) {
+        SDL_Log("Glyph atlas texture failed: %s", SDL_GetError());
+        return;
+    }
+    // Start fully transparent so filtering at glyph edges never picks up garbage
+    std::vector<Uint32> clearPixels((size_t)SIZE * SIZE, 0);
+    SDL_UpdateTexture(tex, nullptr, clearPixels.data(), SIZE * 4);
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    clear();
+}
+
+void GlyphAtlas::clear() {
+    if (tex) SDL_DestroyTexture(tex);
+    tex = nullptr;
+    glyphs.clear();
+    missing.clear();
+    penX = penY = rowH = 0;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::glyph(Uint16 ch) {
+    auto it = glyphs.find(ch);
+    if (it != glyphs.end()) return &it->second;
+    if (!tex || missing.count(ch)) return nullptr;
+
+    int minX, maxX, minY, maxY, advance;
+    if (TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance) != 0) {
+        missing.insert(ch);
+        return nullptr;
+    }
+
+    // Blank glyphs such as the space may render to nothing and only advance the pen
+    Glyph g{ { 0, 0, 0, 0 }, advance };
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, ch, SDL_Color{ 255, 255, 255, 255 });
+    SDL_Surface* surf = rendered ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+    if (rendered) SDL_FreeSurface(rendered);
+    if (surf && surf->w > 0 && surf->h > 0) {
+        if (penX + surf->w > SIZE) {
+            penX = 0;
+            penY += rowH + PAD;
+            rowH = 0;
+        }
+        if (surf->w > SIZE || penY + surf->h > SIZE) {
+            SDL_Log("Glyph atlas full, skipping U+%04X", (unsigned)ch);
+            SDL_FreeSurface(surf);
+            missing.insert(ch);
+            return nullptr;
+        }
+        g.src = { penX, penY, surf->w, surf->h };
+        SDL_UpdateTexture(tex, &g.src, surf->pixels, surf->pitch);
+        penX += surf->w + PAD;
+        rowH = std::max(rowH, surf->h);
+    }
+    if (surf) SDL_FreeSurface(surf);
+    return &(glyphs[ch] = g);
+}
+
+// Next code point of a UTF-8 string, advancing i; malformed bytes read as U+FFFD
+static Uint32 nextCodePoint(const std::string& s, size_t& i) {
+    unsigned char c = (unsigned char)s[i++];
+    int extra = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+    if (extra < 0) return 0xFFFD;
+    Uint32 cp = extra == 0 ? c : (c & (0x3F >> extra));
+    for (int k = 0; k < extra; ++k) {
+        if (i >= s.size() || ((unsigned char)s[i] & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | ((unsigned char)s[i++] & 0x3F);
+    }
+    return cp;
+}
+
+bool TextLabel::set(GlyphAtlas& glyphAtlas, const std::string& utf8) {
+    if (laidOut && atlas == &glyphAtlas && text == utf8) return false;
+    atlas = &glyphAtlas;
+    text = utf8;
+    laidOut = true;
+
+    glyphs.clear();
+    w = 0;
+    h = glyphAtlas.lineHeight();
+    int pen = 0;
+    for (size_t i = 0; i < utf8.size();) {
+        Uint32 cp = nextCodePoint(utf8, i);
+        if (cp > 0xFFFF) continue;
+        const GlyphAtlas::Glyph* g = glyphAtlas.glyph((Uint16)cp);
+        if (!g) continue;
+        if (g->src.w > 0) {
+            glyphs.push_back({ g->src, pen });
+            w = std::max(w, pen + g->src.w);
+        }
+        pen += g->advance;
+        w = std::max(w, pen);
+    }
+    return true;
+}
+
+void TextLabel::draw(SpriteBatch& batch, int x, int y, SDL_Color color) const {
+    if (!atlas || !atlas->texture()) return;
+    for (const Placed& g : glyphs) {
+        SDL_Rect dst{ x + g.x, y, g.src.w, g.src.h };
+        batch.draw(atlas->texture(), g.src, dst, SDL_FLIP_NONE, color);
+    }
+}
@@ -2,10 +2,16 @@
 #include <SDL.h>
 #include <cmath>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <filesystem>
 #include "ZipUtil.h"
+#include "LevelStream.h"
+#include "Tiles.h"
 
 Level::Level()
     : bgTexture(nullptr)
@@ -21,10 +27,12 @@ Level::Level()
     , prevCamValid(false)
     , bgMaxSpeed(-1.0f)
 {
-    grid.assign(rows, std::vector<int>(cols, 0));
+    resizeGrid(rows, cols);
 }
 
 Level::~Level() = default;
+Level::Level(Level&& other) noexcept = default;
+Level& Level::operator=(Level&& other) noexcept = default;
 
 void Level::setBackgroundTexture(SDL_Texture* tex) {
     bgTexture = tex;
@@ -201,111 +209,626 @@ void Level::renderBackground(SDL_Renderer* renderer) {
 }
 
 void Level::toggleCell(int r, int c) {
-    if (r < 0 || c < 0) return;
-    // ensure grid has enough rows/cols
-    if (r >= rows) {
-        grid.resize(r + 1);
-        for (int i = rows; i <= r; ++i) grid[i].assign(cols, 0);
-        rows = r + 1;
-    }
-    if (c >= cols) {
-        for (auto &row : grid) row.resize(c + 1, 0);
-        cols = c + 1;
-    }
+    ensureCell(r, c);
     // toggle between 0 and 1
-    grid[r][c] = (grid[r][c] == 0) ? 1 : 0;
+    setTile(r, c, tile(r, c) == 0 ? 1 : 0);
 }
 
 void Level::ensureCell(int r, int c) {
     if (r < 0 || c < 0) return;
-    if (r >= rows) {
-        grid.resize(r + 1);
-        for (int i = rows; i <= r; ++i) grid[i].assign(cols, 0);
-        rows = r + 1;
+    // Streamed levels keep their size; the chunk layout depends on it
+    if (stream) return;
+    if (r < rows && c < cols) return;
+    // Grow the capacity geometrically so adding one row or column at a time stays cheap
+    int capRows = gridStride > 0 ? static_cast<int>(grid.size() / gridStride) : 0;
+    reserveGrid(r < capRows ? capRows : std::max(r + 1, capRows * 2),
+                c < gridStride ? gridStride : std::max(c + 1, gridStride * 2));
+    resizeGrid(std::max(rows, r + 1), std::max(cols, c + 1));
+}
+
+void Level::reset(int newRows, int newCols) {
+    stream.reset();
+    gridRow0 = 0;
+    gridCol0 = 0;
+    grid.clear();
+    gridRows = gridCols = gridStride = 0;
+    rebuildSolid();
+    resizeGrid(newRows, newCols);
+}
+
+// Makes room for at least capRows x capCols tiles without changing the level size
+void Level::reserveGrid(int capRows, int capCols) {
+    int oldCapRows = gridStride > 0 ? static_cast<int>(grid.size() / gridStride) : 0;
+    capRows = std::max(capRows, oldCapRows);
+    capCols = std::max(capCols, gridStride);
+    if (capRows == oldCapRows && capCols == gridStride) return;
+
+    std::vector<uint8_t> next((size_t)capRows * capCols, 0);
+    for (int r = 0; r < gridRows; ++r) {
+        const uint8_t* src = &grid[(size_t)r * gridStride];
+        std::copy(src, src + gridCols, next.begin() + (size_t)r * capCols);
+    }
+    grid.swap(next);
+    gridStride = capCols;
+    rebuildSolid();
+}
+
+// Resizes a fully resident level, keeping the tiles that still fit
+void Level::resizeGrid(int newRows, int newCols) {
+    newRows = std::max(0, newRows);
+    newCols = std::max(0, newCols);
+    reserveGrid(newRows, newCols);
+    // Clear what falls outside the new size so growing again reads empty cells
+    bool shrinking = newRows < gridRows || newCols < gridCols;
+    for (int r = 0; r < gridRows; ++r) {
+        uint8_t* row = &grid[(size_t)r * gridStride];
+        if (r >= newRows) std::fill(row, row + gridCols, 0);
+        else if (newCols < gridCols) std::fill(row + newCols, row + gridCols, 0);
     }
-    if (c >= cols) {
-        for (auto &row : grid) row.resize(c + 1, 0);
-        cols = c + 1;
+    rows = gridRows = newRows;
+    cols = gridCols = newCols;
+    if (shrinking) rebuildSolid();
+}
+
+// Bits and patrol data are kept for the whole allocated grid so growing into spare
+// cells needs no rebuild. Every bulk change of the tiles ends up here.
+void Level::rebuildSolid() {
+    ++revision;
+    tileEdits.clear();
+    int capRows = gridStride > 0 ? static_cast<int>(grid.size() / gridStride) : 0;
+    solid.reset(capRows, gridStride);
+    for (int r = 0; r < gridRows; ++r) {
+        const uint8_t* row = &grid[(size_t)r * gridStride];
+        for (int c = 0; c < gridCols; ++c) {
+            if (Tiles::flags(row[c]) & Tiles::F_SOLID) solid.set(r, c, true);
+        }
     }
+    patrol.rebuild(solid);
 }
 
-bool Level::saveToZip(const std::string& path, const std::string& assetsDir) const {
-    std::ostringstream ss;
-    ss << "rows=" << rows << "\n";
-    ss << "cols=" << cols << "\n";
-    ss << "backgroundPath=" << backgroundPath << "\n";
-    for (size_t i = 0; i < usedAssets.size(); ++i) {
-        ss << "usedAsset=" << usedAssets[i] << "\n";
+int Level::firstSolidBelow(int r, int c) const {
+    int hit = solid.firstInCol(c - gridCol0, r - gridRow0, gridRows - 1);
+    return hit < 0 ? -1 : hit + gridRow0;
+}
+
+bool Level::anySolidInSpan(int r, int c0, int c1) const {
+    if (c0 > c1) std::swap(c0, c1);
+    return solid.firstInRow(r - gridRow0, c0 - gridCol0, c1 - gridCol0) >= 0;
+}
+
+int Level::raycastRow(int r, int c0, int c1) const {
+    int hit = c0 <= c1 ? solid.firstInRow(r - gridRow0, c0 - gridCol0, c1 - gridCol0)
+                       : solid.lastInRow(r - gridRow0, c1 - gridCol0, c0 - gridCol0);
+    return hit < 0 ? -1 : hit + gridCol0;
+}
+
+void Level::setTile(int r, int c, int value) {
+    if (!isResident(r, c)) return;
+    grid[(size_t)(r - gridRow0) * gridStride + (c - gridCol0)] = static_cast<uint8_t>(value);
+    bool isSolidNow = (Tiles::flags(static_cast<uint8_t>(value)) & Tiles::F_SOLID) != 0;
+    if (solid.test(r - gridRow0, c - gridCol0) != isSolidNow) {
+        solid.set(r - gridRow0, c - gridCol0, isSolidNow);
+        patrol.update(solid, r - gridRow0, c - gridCol0);
+    }
+    if (stream) {
+        stream->dirty.insert(LevelStream::chunkKey(r / LevelStream::CHUNK_ROWS, c / LevelStream::CHUNK_COLS));
+    }
+    if (tileEdits.size() < MAX_TILE_EDITS) {
+        tileEdits.push_back({ r, c });
+    } else {
+        tileEdits.clear();
+        ++revision;
+    }
+}
+
+void Level::takeTileEdits(std::vector<std::pair<int, int>>& out) {
+    out.clear();
+    out.swap(tileEdits);
+}
+
+// Copies one chunk of tiles (row-major, CHUNK_ROWS x CHUNK_COLS) out of the grid or,
+// for streamed chunks that are not resident, out of the archive.
+void Level::copyChunk(int cy, int cx, uint8_t* out) const {
+    const int CR = LevelStream::CHUNK_ROWS, CC = LevelStream::CHUNK_COLS;
+    if (stream && (cy < stream->cy0 || cy >= stream->cy1 || cx < stream->cx0 || cx >= stream->cx1)) {
+        stream->readChunk(cy, cx, out);
+        return;
+    }
+    memset(out, 0, LevelStream::CHUNK_TILES);
+    for (int r = 0; r < CR; ++r) {
+        for (int c = 0; c < CC; ++c) {
+            out[r * CC + c] = static_cast<uint8_t>(tile(cy * CR + r, cx * CC + c));
+        }
+    }
+}
+
+void Level::setWindow(int cy0, int cy1, int cx0, int cx1) {
+    LevelStream& s = *stream;
+    const int CR = LevelStream::CHUNK_ROWS, CC = LevelStream::CHUNK_COLS;
+    std::vector<uint8_t> chunk(LevelStream::CHUNK_TILES);
+
+    // Edited chunks leaving the window are stashed so the edits survive until saved
+    for (int cy = s.cy0; cy < s.cy1; ++cy) {
+        for (int cx = s.cx0; cx < s.cx1; ++cx) {
+            if (cy >= cy0 && cy < cy1 && cx >= cx0 && cx < cx1) continue;
+            auto it = s.dirty.find(LevelStream::chunkKey(cy, cx));
+            if (it == s.dirty.end()) continue;
+            copyChunk(cy, cx, chunk.data());
+            s.stashChunk(cy, cx, chunk.data());
+            s.dirty.erase(it);
+        }
+    }
+
+    int row0 = cy0 * CR, col0 = cx0 * CC;
+    int windowRows = std::max(0, std::min(rows, cy1 * CR) - row0);
+    int windowCols = std::max(0, std::min(cols, cx1 * CC) - col0);
+    std::vector<uint8_t> next((size_t)windowRows * windowCols, 0);
+
+    for (int cy = cy0; cy < cy1; ++cy) {
+        for (int cx = cx0; cx < cx1; ++cx) {
+            bool resident = cy >= s.cy0 && cy < s.cy1 && cx >= s.cx0 && cx < s.cx1;
+            if (!resident) s.readChunk(cy, cx, chunk.data());
+            int rEnd = std::min(rows, (cy + 1) * CR), cEnd = std::min(cols, (cx + 1) * CC);
+            for (int r = cy * CR; r < rEnd; ++r) {
+                uint8_t* dst = &next[(size_t)(r - row0) * windowCols + (cx * CC - col0)];
+                const uint8_t* src = resident ? &grid[(size_t)(r - gridRow0) * gridStride + (cx * CC - gridCol0)]
+                                              : &chunk[(r - cy * CR) * CC];
+                std::copy(src, src + (cEnd - cx * CC), dst);
+            }
+        }
+    }
+
+    grid.swap(next);
+    gridRow0 = row0;
+    gridCol0 = col0;
+    gridRows = windowRows;
+    gridCols = gridStride = windowCols;
+    rebuildSolid();
+    s.cy0 = cy0; s.cy1 = cy1;
+    s.cx0 = cx0; s.cx1 = cx1;
+}
+
+void Level::streamAround(float camX, float camY, int viewW, int viewH, int tilePx) {
+    if (!stream || tilePx <= 0 || stream->chunksX == 0 || stream->chunksY == 0) return;
+    LevelStream& s = *stream;
+    const int CR = LevelStream::CHUNK_ROWS, CC = LevelStream::CHUNK_COLS;
+
+    int firstCol = std::max(0, static_cast<int>(std::floor(camX / tilePx)));
+    int lastCol = std::max(firstCol, static_cast<int>(std::floor((camX + viewW) / tilePx)));
+    int firstRow = std::max(0, static_cast<int>(std::floor(camY / tilePx)));
+    int lastRow = std::max(firstRow, static_cast<int>(std::floor((camY + viewH) / tilePx)));
+
+    int needCx0 = std::min(firstCol / CC, s.chunksX - 1);
+    int needCx1 = std::min(lastCol / CC + 1, s.chunksX);
+    int needCy0 = std::min(firstRow / CR, s.chunksY - 1);
+    int needCy1 = std::min(lastRow / CR + 1, s.chunksY);
+    if (needCx0 >= s.cx0 && needCx1 <= s.cx1 && needCy0 >= s.cy0 && needCy1 <= s.cy1) return;
+
+    // Keep a chunk of margin on every side so small camera moves don't reload anything
+    setWindow(std::max(0, needCy0 - 1), std::min(s.chunksY, needCy1 + 1),
+              std::max(0, needCx0 - 1), std::min(s.chunksX, needCx1 + 1));
+}
+
+void Level::countTiles(uint32_t counts[256]) const {
+    if (!stream) {
+        for (int r = 0; r < gridRows; ++r) {
+            const uint8_t* row = &grid[(size_t)r * gridStride];
+            for (int c = 0; c < gridCols; ++c) counts[row[c]]++;
+        }
+        return;
+    }
+    // Chunks are padded with empty tiles past the level edge; don't count those
+    const int CR = LevelStream::CHUNK_ROWS, CC = LevelStream::CHUNK_COLS;
+    std::vector<uint8_t> chunk(LevelStream::CHUNK_TILES);
+    for (int cy = 0; cy < stream->chunksY; ++cy) {
+        for (int cx = 0; cx < stream->chunksX; ++cx) {
+            copyChunk(cy, cx, chunk.data());
+            int h = std::min(CR, rows - cy * CR), w = std::min(CC, cols - cx * CC);
+            for (int r = 0; r < h; ++r) {
+                for (int c = 0; c < w; ++c) counts[chunk[r * CC + c]]++;
+            }
+        }
+    }
+}
+
+void Level::markEnemySpawns() {
+    for (const auto& e : enemyPositions) {
+        setTile(e.first, e.second, 5);
+    }
+}
+
+void Level::collectEnemySpawns() {
+    std::vector<std::pair<int, int>> spawns;
+    for (const auto& e : enemyPositions) {
+        bool inLevel = e.first >= 0 && e.first < rows && e.second >= 0 && e.second < cols;
+        if (stream && inLevel && !isResident(e.first, e.second)) spawns.push_back(e);
     }
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            int v = 0;
-            if (r < static_cast<int>(grid.size()) && c < static_cast<int>(grid[r].size())) v = grid[r][c];
-            ss << "grid" << r << "," << c << "=" << v << "\n";
+    for (int r = 0; r < gridRows; ++r) {
+        const uint8_t* row = &grid[(size_t)r * gridStride];
+        for (int c = 0; c < gridCols; ++c) {
+            if (row[c] == 5) spawns.push_back({ gridRow0 + r, gridCol0 + c });
+        }
+    }
+    std::sort(spawns.begin(), spawns.end());
+    enemyPositions.swap(spawns);
+}
+
+// layout.bin, version 1 (little-endian):
+//   char[4] magic "PJLV", uint16 version, uint16 flags,
+//   int32 rows, int32 cols, uint32 enemy count,
+//   uint16 background path length + path bytes,
+//   uint8 tiles[rows * cols] (row-major), or with LAYOUT_FLAG_CHUNKED
+//   uint16 chunk rows, uint16 chunk cols and the tiles in chunk_<cy>_<cx>.bin entries,
+//   int32 row, int32 col per enemy.
+static const char LAYOUT_MAGIC[4] = { 'P', 'J', 'L', 'V' };
+static const uint16_t LAYOUT_VERSION = 1;
+static const uint16_t LAYOUT_FLAG_CHUNKED = 1;
+static const size_t LAYOUT_HEADER_SIZE = 20;
+
+template <typename T>
+static void putValue(std::string& out, T v) {
+    char bytes[sizeof(T)];
+    memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+static T getValue(const char* p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+std::string Level::serializeBinaryLayout(bool chunked) const {
+    std::string out;
+    out.reserve(LAYOUT_HEADER_SIZE + 6 + backgroundPath.size() + (chunked ? 0 : (size_t)rows * cols) + enemyPositions.size() * 8);
+    out.append(LAYOUT_MAGIC, sizeof(LAYOUT_MAGIC));
+    putValue<uint16_t>(out, LAYOUT_VERSION);
+    putValue<uint16_t>(out, chunked ? LAYOUT_FLAG_CHUNKED : 0);
+    putValue<int32_t>(out, rows);
+    putValue<int32_t>(out, cols);
+    putValue<uint32_t>(out, (uint32_t)enemyPositions.size());
+    putValue<uint16_t>(out, (uint16_t)backgroundPath.size());
+    out.append(backgroundPath);
+
+    if (chunked) {
+        putValue<uint16_t>(out, LevelStream::CHUNK_ROWS);
+        putValue<uint16_t>(out, LevelStream::CHUNK_COLS);
+    } else {
+        // A fully resident grid is already in file order unless the editor left spare columns
+        if (gridStride == cols) {
+            out.append(reinterpret_cast<const char*>(grid.data()), (size_t)rows * cols);
+        } else {
+            for (int r = 0; r < rows; ++r) out.append(reinterpret_cast<const char*>(&grid[(size_t)r * gridStride]), cols);
         }
     }
+
     for (size_t i = 0; i < enemyPositions.size(); ++i) {
-        ss << "enemy=" << enemyPositions[i].first << "," << enemyPositions[i].second << "\n";
+        putValue<int32_t>(out, enemyPositions[i].first);
+        putValue<int32_t>(out, enemyPositions[i].second);
     }
-    std::string layout = ss.str();
+    return out;
+}
 
-    std::string assetsStr;
-    for (size_t i = 0; i < usedAssets.size(); ++i) {
-        if (i) assetsStr += "\n";
-        assetsStr += usedAssets[i];
+std::string Level::serializeTextLayout() const {
+    std::string out;
+    out += "rows=" + std::to_string(rows) + "\n";
+    out += "cols=" + std::to_string(cols) + "\n";
+    out += "backgroundPath=" + backgroundPath + "\n";
+    for (int r = 0; r < gridRows; ++r) {
+        const uint8_t* row = &grid[(size_t)r * gridStride];
+        int n = gridCols;
+        // Trailing empty cells are implied, so empty rows are left out entirely
+        while (n > 0 && row[n - 1] == 0) --n;
+        if (n == 0) continue;
+        out += "row=" + std::to_string(r) + ":";
+        for (int c = 0; c < n;) {
+            int run = 1;
+            while (c + run < n && row[c + run] == row[c]) ++run;
+            if (c > 0) out += ',';
+            out += std::to_string((int)row[c]);
+            if (run > 1) out += "x" + std::to_string(run);
+            c += run;
+        }
+        out += "\n";
+    }
+    for (const auto& e : enemyPositions) {
+        out += "enemy=" + std::to_string(e.first) + "," + std::to_string(e.second) + "\n";
+    }
+    return out;
+}
+
+bool Level::parseBinaryLayout(const char* p, size_t size, bool& chunked) {
+    if (size < LAYOUT_HEADER_SIZE + 2) return false;
+    if (memcmp(p, LAYOUT_MAGIC, sizeof(LAYOUT_MAGIC)) != 0) return false;
+    if (getValue<uint16_t>(p + 4) != LAYOUT_VERSION) {
+        SDL_Log("Unsupported layout.bin version %u", (unsigned)getValue<uint16_t>(p + 4));
+        return false;
+    }
+    chunked = (getValue<uint16_t>(p + 6) & LAYOUT_FLAG_CHUNKED) != 0;
+    int32_t newRows = getValue<int32_t>(p + 8);
+    int32_t newCols = getValue<int32_t>(p + 12);
+    uint32_t enemyCount = getValue<uint32_t>(p + 16);
+    size_t bgLen = getValue<uint16_t>(p + LAYOUT_HEADER_SIZE);
+    if (newRows < 0 || newCols < 0) return false;
+
+    size_t tilesOffset = LAYOUT_HEADER_SIZE + 2 + bgLen;
+    size_t tileBytes = chunked ? 4 : (size_t)newRows * (size_t)newCols;
+    size_t enemyOffset = tilesOffset + tileBytes;
+    if (size < enemyOffset + (size_t)enemyCount * 8) return false;
+
+    rows = newRows;
+    cols = newCols;
+    backgroundPath.assign(p + LAYOUT_HEADER_SIZE + 2, bgLen);
+
+    if (chunked) {
+        // Tiles are read chunk by chunk once the level is streamed
+        if (getValue<uint16_t>(p + tilesOffset) != LevelStream::CHUNK_ROWS ||
+            getValue<uint16_t>(p + tilesOffset + 2) != LevelStream::CHUNK_COLS) {
+            SDL_Log("Unsupported layout.bin chunk size %ux%u",
+                    (unsigned)getValue<uint16_t>(p + tilesOffset), (unsigned)getValue<uint16_t>(p + tilesOffset + 2));
+            return false;
+        }
+        grid.clear();
+        gridRows = gridCols = gridStride = 0;
+    } else {
+        const uint8_t* tiles = reinterpret_cast<const uint8_t*>(p + tilesOffset);
+        grid.assign(tiles, tiles + tileBytes);
+        gridRows = rows;
+        gridCols = gridStride = cols;
     }
 
-    std::string bgPath = assetsDir + backgroundPath;
-    return saveLevelZip(path, layout, assetsStr, bgPath);
+    enemyPositions.clear();
+    enemyPositions.reserve(enemyCount);
+    for (uint32_t i = 0; i < enemyCount; ++i) {
+        const char* e = p + enemyOffset + (size_t)i * 8;
+        enemyPositions.push_back({ getValue<int32_t>(e), getValue<int32_t>(e + 4) });
+    }
+    return true;
 }
 
-bool Level::loadFromFile(const std::string& path) {
-    std::string layout, assets;
-    if (!loadLevelZip(path, layout, assets)) return false;
-
-    // Parse layout
-    std::istringstream iss(layout);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.empty()) continue;
+static int toInt(std::string_view s) {
+    int v = 0;
+    std::from_chars(s.data(), s.data() + s.size(), v);
+    return v;
+}
+
+// Calls fn(line) for every non-empty line of the buffer, without copying.
+template <typename Fn>
+static void forEachLine(const char* data, size_t size, Fn fn) {
+    std::string_view rest(data, size);
+    while (!rest.empty()) {
+        size_t nl = rest.find('\n');
+        std::string_view line = rest.substr(0, nl);
+        rest = (nl == std::string_view::npos) ? std::string_view() : rest.substr(nl + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) fn(line);
+    }
+}
+
+void Level::parseTextLayout(const char* data, size_t size) {
+    // row=N:<runs>, each run "<value>" or "<value>x<count>", comma separated;
+    // cells after the last run are empty
+    auto parseTextRow = [this](std::string_view value) {
+        size_t colon = value.find(':');
+        if (colon == std::string_view::npos) return;
+        int r = toInt(value.substr(0, colon));
+        if (r < 0 || r >= rows || cols <= 0) return;
+        if (gridRows != rows || gridCols != cols) resizeGrid(rows, cols);
+        uint8_t* row = &grid[(size_t)r * gridStride];
+        std::fill(row, row + cols, 0);
+
+        std::string_view runs = value.substr(colon + 1);
+        int c = 0;
+        while (!runs.empty() && c < cols) {
+            size_t comma = runs.find(',');
+            std::string_view run = runs.substr(0, comma);
+            runs = (comma == std::string_view::npos) ? std::string_view() : runs.substr(comma + 1);
+            size_t x = run.find('x');
+            int v = toInt(run.substr(0, x));
+            int n = (x == std::string_view::npos) ? 1 : toInt(run.substr(x + 1));
+            n = std::max(0, std::min(n, cols - c));
+            std::fill(row + c, row + c + n, static_cast<uint8_t>(v));
+            c += n;
+        }
+    };
+
+    forEachLine(data, size, [this, &parseTextRow](std::string_view line) {
         size_t eq = line.find('=');
-        if (eq == std::string::npos) continue;
-        std::string key = line.substr(0, eq);
-        std::string value = line.substr(eq + 1);
+        if (eq == std::string_view::npos) return;
+        std::string_view key = line.substr(0, eq);
+        std::string_view value = line.substr(eq + 1);
         if (key == "rows") {
-            rows = std::stoi(value);
+            rows = toInt(value);
         } else if (key == "cols") {
-            cols = std::stoi(value);
+            cols = toInt(value);
         } else if (key == "backgroundPath") {
-            backgroundPath = value;
-        } else if (key == "usedAsset") {
-            usedAssets.push_back(value);
+            backgroundPath.assign(value.data(), value.size());
         } else if (key.substr(0, 4) == "grid") {
             size_t comma = key.find(',');
-            if (comma != std::string::npos) {
-                int r = std::stoi(key.substr(4, comma - 4));
-                int c = std::stoi(key.substr(comma + 1));
-                if (r >= rows || c >= cols) continue;
-                if (r >= static_cast<int>(grid.size())) grid.resize(r + 1);
-                if (c >= static_cast<int>(grid[r].size())) grid[r].resize(c + 1, 0);
-                grid[r][c] = std::stoi(value);
+            if (comma != std::string_view::npos) {
+                int r = toInt(key.substr(4, comma - 4));
+                int c = toInt(key.substr(comma + 1));
+                if (r < 0 || c < 0 || r >= rows || c >= cols) return;
+                if (gridRows != rows || gridCols != cols) resizeGrid(rows, cols);
+                grid[(size_t)r * gridStride + c] = static_cast<uint8_t>(toInt(value));
             }
+        } else if (key == "row") {
+            parseTextRow(value);
         } else if (key == "enemy") {
             size_t comma = value.find(',');
-            if (comma != std::string::npos) {
-                int r = std::stoi(value.substr(0, comma));
-                int c = std::stoi(value.substr(comma + 1));
-                enemyPositions.push_back({r, c});
+            if (comma != std::string_view::npos) {
+                enemyPositions.push_back({ toInt(value.substr(0, comma)), toInt(value.substr(comma + 1)) });
+            }
+        }
+    });
+
+    // Cells missing from the file stay empty
+    resizeGrid(rows, cols);
+}
+
+bool Level::saveToZip(const std::string& path, const std::string& assetsDir, LayoutFormat format) {
+    std::string tmpPath = path + ".tmp";
+    if (!writeZip(tmpPath, assetsDir, format)) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return replaceArchive(tmpPath, path, true);
+}
+
+bool Level::writeZip(const std::string& path, const std::string& assetsDir, LayoutFormat format) const {
+    bool chunked = stream || (size_t)rows * cols > (size_t)STREAM_MIN_TILES;
+    bool text = format == LayoutFormat::Text && !stream;
+    if (text) chunked = false;
+    std::string layout = text ? serializeTextLayout() : serializeBinaryLayout(chunked);
+    const char* layoutEntry = text ? LAYOUT_TXT_ENTRY : LAYOUT_BIN_ENTRY;
+
+    std::string assetsStr;
+    for (size_t i = 0; i < usedAssets.size(); ++i) {
+        if (i) assetsStr += "\n";
+        assetsStr += usedAssets[i];
+    }
+
+    // The background that came with the level is stored again as is; only levels
+    // created in the editor read it from assetsDir
+    std::vector<char> bgFile;
+    if (backgroundData.empty() && !backgroundPath.empty()) {
+        std::ifstream file(assetsDir + backgroundPath, std::ios::binary);
+        if (file) bgFile.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const std::vector<char>& bgData = backgroundData.empty() ? bgFile : backgroundData;
+    std::string bgName = backgroundPath.substr(backgroundPath.find_last_of("/\\") + 1);
+
+    if (!chunked) return saveLevelZip(path, layoutEntry, layout, assetsStr, bgName, bgData);
+
+    auto writeChunks = [this](ZipWriter& zip) {
+        int chunksY = (rows + LevelStream::CHUNK_ROWS - 1) / LevelStream::CHUNK_ROWS;
+        int chunksX = (cols + LevelStream::CHUNK_COLS - 1) / LevelStream::CHUNK_COLS;
+        std::vector<uint8_t> chunk(LevelStream::CHUNK_TILES);
+        for (int cy = 0; cy < chunksY; ++cy) {
+            for (int cx = 0; cx < chunksX; ++cx) {
+                copyChunk(cy, cx, chunk.data());
+                if (!zip.add(LevelStream::chunkName(cy, cx), reinterpret_cast<const char*>(chunk.data()), chunk.size())) return false;
             }
         }
+        return true;
+    };
+    return saveLevelZip(path, layoutEntry, layout, assetsStr, bgName, bgData, writeChunks);
+}
+
+bool Level::readsFrom(const std::string& path) const {
+    std::error_code ec;
+    return stream && std::filesystem::equivalent(stream->path, path, ec);
+}
+
+bool Level::replaceArchive(const std::string& tmpPath, const std::string& path, bool dropStash) {
+    // The archive can't be replaced while this level holds it open
+    bool reading = readsFrom(path);
+    if (reading) stream->zip.close();
+    bool ok = replaceFile(tmpPath, path);
+    if (reading) {
+        if (!stream->reopen()) {
+            SDL_Log("Failed to reopen %s", path.c_str());
+            return false;
+        }
+        // Everything stashed is in the archive now
+        if (ok && dropStash) stream->stash.clear();
+    }
+    return ok;
+}
+
+Level Level::snapshot() const {
+    Level copy;
+    copy.rows = rows;
+    copy.cols = cols;
+    copy.grid = grid;
+    copy.gridRow0 = gridRow0;
+    copy.gridCol0 = gridCol0;
+    copy.gridRows = gridRows;
+    copy.gridCols = gridCols;
+    copy.gridStride = gridStride;
+    copy.solid = solid;
+    copy.patrol = patrol;
+    copy.backgroundPath = backgroundPath;
+    copy.backgroundData = backgroundData;
+    copy.usedAssets = usedAssets;
+    copy.enemyPositions = enemyPositions;
+    if (stream) {
+        copy.stream.reset(new LevelStream(stream->path, rows, cols));
+        copy.stream->cy0 = stream->cy0;
+        copy.stream->cy1 = stream->cy1;
+        copy.stream->cx0 = stream->cx0;
+        copy.stream->cx1 = stream->cx1;
+        copy.stream->stash = stream->stash;
+    }
+    return copy;
+}
+
+bool Level::loadFromFile(const std::string& path) {
+    // Parse into a scratch level so a bad archive leaves this one untouched
+    Level loaded;
+    if (!loaded.readArchive(path)) return false;
+    takeLayout(loaded);
+    return true;
+}
+
+bool Level::readArchive(const std::string& path) {
+    ZipReader zip;
+    if (!zip.open(path)) return false;
+
+    // Inflate straight into a reused buffer and parse it in place
+    static thread_local std::vector<char> buffer;
+    bool binaryLayout = zip.read(LAYOUT_BIN_ENTRY, buffer);
+    if (!binaryLayout && !zip.read(LAYOUT_TXT_ENTRY, buffer)) return false;
+    if (buffer.empty()) return false;
+
+    bool chunked = false;
+    enemyPositions.clear();
+    if (binaryLayout) {
+        if (!parseBinaryLayout(buffer.data(), buffer.size(), chunked)) return false;
+    } else {
+        parseTextLayout(buffer.data(), buffer.size());
     }
 
     // Parse assets
-    std::istringstream issAssets(assets);
+    if (!zip.read(ASSETS_ENTRY, buffer) || buffer.empty()) return false;
     usedAssets.clear();
-    while (std::getline(issAssets, line)) {
-        if (!line.empty()) usedAssets.push_back(line);
+    forEachLine(buffer.data(), buffer.size(), [this](std::string_view line) {
+        usedAssets.emplace_back(line);
+    });
+
+    // saveLevelZip stores the background under its file name
+    std::string bgEntry = backgroundPath.substr(backgroundPath.find_last_of("/\\") + 1);
+    if (bgEntry.empty() || !zip.read(bgEntry, backgroundData)) backgroundData.clear();
+
+    if (chunked) {
+        // Keep the archive open and load the chunks at the level start
+        stream.reset(new LevelStream(std::move(zip), path, rows, cols));
+        gridRow0 = 0;
+        gridCol0 = 0;
+        setWindow(0, std::min(stream->chunksY, 2), 0, std::min(stream->chunksX, 2));
+    } else {
+        rebuildSolid();
     }
-
     return true;
 }
+
+void Level::takeLayout(Level& other) {
+    rows = other.rows;
+    cols = other.cols;
+    grid = std::move(other.grid);
+    gridRow0 = other.gridRow0;
+    gridCol0 = other.gridCol0;
+    gridRows = other.gridRows;
+    gridCols = other.gridCols;
+    gridStride = other.gridStride;
+    solid = std::move(other.solid);
+    patrol = std::move(other.patrol);
+    stream = std::move(other.stream);
+    backgroundPath = std::move(other.backgroundPath);
+    backgroundData = std::move(other.backgroundData);
+    usedAssets = std::move(other.usedAssets);
+    enemyPositions = std::move(other.enemyPositions);
+    ++revision;
+    tileEdits.clear();
+}
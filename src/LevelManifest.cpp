@@ -0,0 +1,184 @@
+#include "LevelManifest.h"
+#include "Level.h"
+#include "ZipUtil.h"
+#include "Hash.h"
+#include <SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+static const char* MANIFEST_HEADER = "# projekcik level manifest v1";
+
+// Parses "level_<n>.zip"; returns 0 for any other file name
+static int levelNumberFromName(const std::string& name) {
+    const std::string prefix = "level_", suffix = ".zip";
+    if (name.size() <= prefix.size() + suffix.size()) return 0;
+    if (name.compare(0, prefix.size(), prefix) != 0) return 0;
+    if (name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) return 0;
+    std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+    if (digits.empty() || digits.size() > 6 || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) return 0;
+    return std::stoi(digits);
+}
+
+static bool hashFile(const std::string& path, uint64_t& hash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    uint64_t h = hashBytes(nullptr, 0);
+    char buf[1 << 16];
+    while (file) {
+        file.read(buf, sizeof(buf));
+        h = hashBytes(buf, (size_t)file.gcount(), h);
+    }
+    hash = h;
+    return true;
+}
+
+const LevelInfo* LevelManifest::find(int number) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), number,
+                               [](const LevelInfo& info, int n) { return info.number < n; });
+    return (it != entries.end() && it->number == number) ? &*it : nullptr;
+}
+
+int LevelManifest::refresh(const std::string& dir, const std::string& manifestPath) {
+    std::string manifestFile = (fs::path(dir) / manifestPath).string();
+    load(manifestFile);
+    bool changed = false;
+    int rebuilt = 0;
+
+    std::vector<LevelInfo> current;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        int number = levelNumberFromName(name);
+        if (number <= 0 || !it->is_regular_file(ec)) continue;
+
+        LevelInfo info;
+        info.number = number;
+        info.file = name;
+        info.fileSize = (uint64_t)it->file_size(ec);
+        info.mtime = (int64_t)it->last_write_time(ec).time_since_epoch().count();
+
+        const LevelInfo* known = find(number);
+        if (known && known->file == name && known->fileSize == info.fileSize && known->mtime == info.mtime) {
+            current.push_back(*known);
+            continue;
+        }
+
+        // Touched or new: the contents hash decides whether it has to be parsed again
+        std::string zipPath = it->path().string();
+        changed = true;
+        if (!hashFile(zipPath, info.contentHash)) continue;
+        if (known && known->contentHash == info.contentHash) {
+            LevelInfo same = *known;
+            same.file = name;
+            same.mtime = info.mtime;
+            same.fileSize = info.fileSize;
+            current.push_back(same);
+            continue;
+        }
+        if (!build(zipPath, info)) {
+            SDL_Log("Level manifest: cannot read %s", zipPath.c_str());
+            continue;
+        }
+        current.push_back(info);
+        ++rebuilt;
+    }
+
+    std::sort(current.begin(), current.end(), [](const LevelInfo& a, const LevelInfo& b) { return a.number < b.number; });
+    if (current.size() != entries.size()) changed = true;
+    entries.swap(current);
+
+    if (changed && !save(manifestFile)) SDL_Log("Level manifest: cannot write %s", manifestFile.c_str());
+    return rebuilt;
+}
+
+bool LevelManifest::build(const std::string& zipPath, LevelInfo& info) {
+    Level level;
+    if (!level.loadFromFile(zipPath)) return false;
+
+    info.rows = level.rows;
+    info.cols = level.cols;
+    info.backgroundPath = level.backgroundPath;
+
+    uint32_t counts[256] = {};
+    level.countTiles(counts);
+    // Spawn tiles and the enemy table normally describe the same enemies
+    info.enemyCount = std::max<uint32_t>(counts[5], (uint32_t)level.enemyPositions.size());
+    info.pickupCount = counts[3] + counts[4] + counts[6] + counts[7] + counts[8] + counts[9] + counts[10];
+
+    ZipReader zip;
+    if (zip.open(zipPath)) {
+        info.layoutOffset = zip.has(LAYOUT_BIN_ENTRY) ? zip.dataOffset(LAYOUT_BIN_ENTRY) : zip.dataOffset(LAYOUT_TXT_ENTRY);
+        std::string bgEntry = level.backgroundPath.substr(level.backgroundPath.find_last_of("/\\") + 1);
+        info.backgroundOffset = bgEntry.empty() ? 0 : zip.dataOffset(bgEntry);
+    }
+    return true;
+}
+
+// One tab-separated line of key=value fields per level
+bool LevelManifest::load(const std::string& path) {
+    entries.clear();
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::string line;
+    if (!std::getline(file, line) || line != MANIFEST_HEADER) return false;
+    while (std::getline(file, line)) {
+        LevelInfo info;
+        std::istringstream fields(line);
+        std::string field;
+        while (std::getline(fields, field, '\t')) {
+            size_t eq = field.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = field.substr(0, eq);
+            std::string value = field.substr(eq + 1);
+            if (key == "level") info.number = std::atoi(value.c_str());
+            else if (key == "file") info.file = value;
+            else if (key == "mtime") info.mtime = std::strtoll(value.c_str(), nullptr, 10);
+            else if (key == "size") info.fileSize = std::strtoull(value.c_str(), nullptr, 10);
+            else if (key == "hash") info.contentHash = std::strtoull(value.c_str(), nullptr, 16);
+            else if (key == "rows") info.rows = std::atoi(value.c_str());
+            else if (key == "cols") info.cols = std::atoi(value.c_str());
+            else if (key == "background") info.backgroundPath = value;
+            else if (key == "enemies") info.enemyCount = (uint32_t)std::strtoul(value.c_str(), nullptr, 10);
+            else if (key == "pickups") info.pickupCount = (uint32_t)std::strtoul(value.c_str(), nullptr, 10);
+            else if (key == "layoutOffset") info.layoutOffset = std::strtoull(value.c_str(), nullptr, 10);
+            else if (key == "backgroundOffset") info.backgroundOffset = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        if (info.number > 0 && !info.file.empty()) entries.push_back(info);
+    }
+    std::sort(entries.begin(), entries.end(), [](const LevelInfo& a, const LevelInfo& b) { return a.number < b.number; });
+    return true;
+}
+
+bool LevelManifest::save(const std::string& path) const {
+    // Write next to the target and swap it in, so a crash never leaves half a manifest
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file) return false;
+        file << MANIFEST_HEADER << "\n";
+        for (const auto& info : entries) {
+            char hash[17];
+            snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)info.contentHash);
+            file << "level=" << info.number << "\tfile=" << info.file << "\tmtime=" << info.mtime
+                 << "\tsize=" << info.fileSize << "\thash=" << hash << "\trows=" << info.rows << "\tcols=" << info.cols
+                 << "\tbackground=" << info.backgroundPath << "\tenemies=" << info.enemyCount << "\tpickups=" << info.pickupCount
+                 << "\tlayoutOffset=" << info.layoutOffset << "\tbackgroundOffset=" << info.backgroundOffset << "\n";
+        }
+        if (!file) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
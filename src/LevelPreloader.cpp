@@ -0,0 +1,172 @@
+#include "LevelPreloader.h"
+#include "Hash.h"
+#include "SpriteAtlas.h"
+#include "Texture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+
+static std::string archiveName(int levelNumber) {
+    return "level_" + std::to_string(levelNumber) + ".zip";
+}
+
+// Size and last write time of a level archive, the same change check LevelManifest uses;
+// both are 0 while the archive doesn't exist
+static void archiveStamp(int levelNumber, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    std::filesystem::path path(archiveName(levelNumber));
+    size = (uint64_t)std::filesystem::file_size(path, ec);
+    if (ec) size = 0;
+    auto time = std::filesystem::last_write_time(path, ec);
+    mtime = ec ? 0 : (int64_t)time.time_since_epoch().count();
+}
+
+PreloadedLevel::~PreloadedLevel() {
+    if (background) SDL_FreeSurface(background);
+}
+
+LevelPreloader::LevelPreloader(const std::string& assetsDir, std::vector<PreloadSprite> spriteList, float displayScale)
+    : assetsDir(assetsDir), spriteFiles(std::move(spriteList)), scale(displayScale)
+{
+    worker = std::thread(&LevelPreloader::run, this);
+}
+
+LevelPreloader::~LevelPreloader() {
+    shutdown();
+}
+
+void LevelPreloader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending.clear();
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+
+    ready.clear();
+    for (auto& kv : sprites) {
+        if (kv.second) SDL_FreeSurface(kv.second);
+    }
+    sprites.clear();
+}
+
+void LevelPreloader::prefetch(int levelNumber, int maxLevel) {
+    if (levelNumber < 1 || levelNumber > maxLevel) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        // Neighbours first so the cursor's own level ends up at the front
+        const int order[] = { levelNumber + 1, levelNumber - 1, levelNumber };
+        for (int n : order) {
+            if (n < 1 || n > maxLevel) continue;
+            dropIfStale(n);
+            if (n == inFlight || ready.count(n)) continue;
+            pending.erase(std::remove(pending.begin(), pending.end(), n), pending.end());
+            pending.push_front(n);
+        }
+        trimCache(levelNumber);
+    }
+    cv.notify_all();
+}
+
+std::unique_ptr<PreloadedLevel> LevelPreloader::take(int levelNumber) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Drop queued work for other levels; the menu is closing
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [&](int n) { return n != levelNumber; }), pending.end());
+    cv.wait(lock, [&] {
+        return stopping || (inFlight != levelNumber &&
+               std::find(pending.begin(), pending.end(), levelNumber) == pending.end());
+    });
+    dropIfStale(levelNumber);
+    auto it = ready.find(levelNumber);
+    if (it == ready.end()) return nullptr;
+    std::unique_ptr<PreloadedLevel> result = std::move(it->second);
+    ready.erase(it);
+    return result;
+}
+
+SDL_Surface* LevelPreloader::sprite(const std::string& file) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return spritesReady || stopping; });
+    auto it = sprites.find(file);
+    return it != sprites.end() ? it->second : nullptr;
+}
+
+void LevelPreloader::trimCache(int around) {
+    // Keep the levels closest to the cursor
+    while (ready.size() > MAX_CACHED) {
+        auto farthest = ready.begin();
+        for (auto it = ready.begin(); it != ready.end(); ++it) {
+            if (std::abs(it->first - around) > std::abs(farthest->first - around)) farthest = it;
+        }
+        ready.erase(farthest);
+    }
+}
+
+void LevelPreloader::dropIfStale(int levelNumber) {
+    auto it = ready.find(levelNumber);
+    if (it == ready.end()) return;
+    uint64_t size;
+    int64_t mtime;
+    archiveStamp(levelNumber, size, mtime);
+    if (size != it->second->fileSize || mtime != it->second->mtime) ready.erase(it);
+}
+
+std::unique_ptr<PreloadedLevel> LevelPreloader::load(int levelNumber) {
+    auto pre = std::make_unique<PreloadedLevel>();
+    pre->number = levelNumber;
+    // Stamped before reading, so a write that lands during the read shows up as a change
+    archiveStamp(levelNumber, pre->fileSize, pre->mtime);
+    pre->loaded = pre->level.loadFromFile(archiveName(levelNumber));
+    if (pre->loaded && !pre->level.backgroundData.empty()) {
+        const std::vector<char>& bg = pre->level.backgroundData;
+        pre->backgroundHash = hashBytes(bg.data(), bg.size());
+        pre->background = Texture::decodeMemory(bg.data(), bg.size(), pre->level.backgroundPath);
+    }
+    return pre;
+}
+
+void LevelPreloader::run() {
+    // Sprites are shared by every level: decode and scale them once, so a level start
+    // only packs them into the atlas
+    std::unordered_map<std::string, SDL_Surface*> decoded;
+    for (const auto& sprite : spriteFiles) {
+        SDL_Surface* source = Texture::decodeFile(assetsDir + sprite.file);
+        SDL_Surface* scaled = nullptr;
+        if (source) {
+            scaled = SpriteAtlas::scaleToHeight(source, (int)std::ceil(sprite.drawH * scale), sprite.file);
+            SDL_FreeSurface(source);
+        }
+        decoded[sprite.file] = scaled;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sprites = std::move(decoded);
+        spritesReady = true;
+    }
+    cv.notify_all();
+
+    while (true) {
+        int next = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return stopping || !pending.empty(); });
+            if (stopping) return;
+            next = pending.front();
+            pending.pop_front();
+            inFlight = next;
+        }
+
+        std::unique_ptr<PreloadedLevel> pre = load(next);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[next] = std::move(pre);
+            inFlight = 0;
+        }
+        cv.notify_all();
+    }
+}
@@ -0,0 +1,110 @@
+#include "LevelSaver.h"
+#include "ZipUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+LevelSaver::LevelSaver() {
+    worker = std::thread(&LevelSaver::run, this);
+}
+
+LevelSaver::~LevelSaver() {
+    shutdown();
+}
+
+void LevelSaver::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void LevelSaver::save(const Level& level, const std::string& path, const std::string& assetsDir) {
+    Job job;
+    job.path = path;
+    job.assetsDir = assetsDir;
+    job.level.reset(new Level(level.snapshot()));
+    job.replaceOnMainThread = level.readsFrom(path);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        auto it = std::find_if(queue.begin(), queue.end(), [&](const Job& j) { return j.path == path; });
+        if (it != queue.end()) {
+            *it = std::move(job);  // not started yet: only the newest snapshot gets written
+        } else {
+            queue.push_back(std::move(job));
+        }
+    }
+    cv.notify_all();
+}
+
+std::vector<LevelSaver::Result> LevelSaver::poll(Level& level) {
+    std::string path;
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = awaitingPath;
+        results.swap(done);
+    }
+    if (!path.empty()) {
+        // The worker waits for this rename before it starts the next save. The level may
+        // have edits newer than the snapshot, so its stash is kept.
+        bool ok = level.replaceArchive(path + ".tmp", path, false);
+        results.push_back({ path, ok });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            awaitingPath.clear();
+        }
+        cv.notify_all();
+    }
+    return results;
+}
+
+std::vector<LevelSaver::Result> LevelSaver::finish(Level& level) {
+    std::vector<Result> results;
+    while (true) {
+        std::vector<Result> batch = poll(level);
+        results.insert(results.end(), batch.begin(), batch.end());
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return !awaitingPath.empty() || !done.empty() || idleLocked(); });
+        if (idleLocked() && done.empty()) break;
+    }
+    return results;
+}
+
+void LevelSaver::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return stopping || (!queue.empty() && awaitingPath.empty()); });
+            // When stopping, queued saves are still written unless one waits for poll()
+            if (queue.empty() || !awaitingPath.empty()) return;
+            job = std::move(queue.front());
+            queue.pop_front();
+            writing = true;
+        }
+
+        std::string tmpPath = job.path + ".tmp";
+        bool ok = job.level->writeZip(tmpPath, job.assetsDir);
+        job.level.reset();  // closes the snapshot's archive handle before any rename
+        if (!ok) {
+            SDL_Log("Failed to write %s", tmpPath.c_str());
+            std::remove(tmpPath.c_str());
+        } else if (!job.replaceOnMainThread) {
+            ok = replaceFile(tmpPath, job.path);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writing = false;
+            if (ok && job.replaceOnMainThread) {
+                awaitingPath = job.path;
+            } else {
+                done.push_back({ job.path, ok });
+            }
+        }
+        cv.notify_all();
+    }
+}
@@ -0,0 +1,45 @@
+#include "LevelStream.h"
+#include <cstdio>
+#include <cstring>
+
+LevelStream::LevelStream(ZipReader&& zip, const std::string& path, int rows, int cols)
+    : zip(std::move(zip)), path(path)
+{
+    chunksY = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    chunksX = (cols + CHUNK_COLS - 1) / CHUNK_COLS;
+}
+
+LevelStream::LevelStream(const std::string& path, int rows, int cols)
+    : LevelStream(ZipReader(), path, rows, cols)
+{
+}
+
+std::string LevelStream::chunkName(int cy, int cx) {
+    char name[48];
+    snprintf(name, sizeof(name), "chunk_%d_%d.bin", cy, cx);
+    return name;
+}
+
+void LevelStream::readChunk(int cy, int cx, uint8_t* out) {
+    auto it = stash.find(chunkKey(cy, cx));
+    if (it != stash.end()) {
+        memcpy(out, it->second.data(), CHUNK_TILES);
+        return;
+    }
+    if (!zip.isOpen() && !zip.open(path)) {
+        memset(out, 0, CHUNK_TILES);
+        return;
+    }
+    std::string name = chunkName(cy, cx);
+    if (zip.entrySize(name) != (size_t)CHUNK_TILES || !zip.read(name, reinterpret_cast<char*>(out), CHUNK_TILES)) {
+        memset(out, 0, CHUNK_TILES);
+    }
+}
+
+void LevelStream::stashChunk(int cy, int cx, const uint8_t* data) {
+    stash[chunkKey(cy, cx)].assign(data, data + CHUNK_TILES);
+}
+
+bool LevelStream::reopen() {
+    return zip.open(path);
+}
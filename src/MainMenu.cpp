@@ -1,4 +1,7 @@
 #include "MainMenu.h"
+#include "LevelManifest.h"
+#include "LevelPreloader.h"
+#include "SaveData.h"
 #include <SDL_image.h>
 #include <SDL.h>
 #include <SDL_mixer.h>
@@ -6,13 +9,32 @@
 #include <string>
 
 static bool isMuted = false;
+static const int BOSS_LEVEL = 10;
 
-MainMenu::MainMenu(SDL_Renderer* ren, const std::string& assetsDir, int maxLevel) : ren(ren), currentIndex(0), maxLevel(maxLevel) {
-    std::vector<std::string> names;
-    for (int i = 1; i <= maxLevel   ; ++i) {
-        std::string name = (i == 10) ? "boss" : std::to_string(i);
-        names.push_back(name);
+MainMenu::MainMenu(SDL_Renderer* ren, const std::string& assetsDir, const LevelManifest& manifest, const SaveData& save,
+                   LevelPreloader* preloader) : ren(ren), currentIndex(0), maxLevel(1), preloader(preloader) {
+    // Levels on disk in order; without a manifest the stock levels 1-9 are assumed
+    std::vector<int> onDisk;
+    for (const LevelInfo& info : manifest.levels()) {
+        if (info.number < BOSS_LEVEL) onDisk.push_back(info.number);
+    }
+    if (manifest.empty()) {
+        for (int i = 1; i < BOSS_LEVEL; ++i) onDisk.push_back(i);
+    }
+
+    // Open up to the level after the last completed one
+    size_t open = 0;
+    for (size_t i = 0; i + 1 < onDisk.size(); ++i) {
+        if (save.completedLevels & (1u << onDisk[i])) open = i + 1;
     }
+    if (save.hasKey) open = onDisk.size();
+    else if (!onDisk.empty()) open += 1;
+    levels.assign(onDisk.begin(), onDisk.begin() + open);
+    if (save.hasKey) levels.push_back(BOSS_LEVEL);
+    if (!levels.empty()) maxLevel = levels.back();
+
+    std::vector<std::string> names;
+    for (int level : levels) names.push_back(level == BOSS_LEVEL ? "boss" : std::to_string(level));
     names.push_back("mute");
     names.push_back("exit");
     names.push_back("kill");
@@ -34,7 +56,14 @@ MainMenu::~MainMenu() {
 
 int MainMenu::run() {
     bool running = true;
+    int prefetched = -1;
     while (running) {
+        // Start loading the level under the cursor (and its neighbours) in the background
+        if (preloader && prefetched != currentIndex) {
+            if (currentIndex < (int)levels.size()) preloader->prefetch(levels[currentIndex], maxLevel);
+            prefetched = currentIndex;
+        }
+
         SDL_Event ev;
         while (SDL_PollEvent(&ev)) {
             if (ev.type == SDL_QUIT) return -1;
@@ -44,9 +73,9 @@ int MainMenu::run() {
                 } else if (ev.key.keysym.scancode == SDL_SCANCODE_RIGHT || ev.key.keysym.scancode == SDL_SCANCODE_D) {
                     currentIndex = (currentIndex + 1) % textures.size();
                 } else if (ev.key.keysym.scancode == SDL_SCANCODE_RETURN || ev.key.keysym.scancode == SDL_SCANCODE_RETURN2) {
-                    if (currentIndex < maxLevel) {
-                        return currentIndex + 1;
-                    } else if (currentIndex == maxLevel) { // mute
+                    if (currentIndex < (int)levels.size()) {
+                        return levels[currentIndex];
+                    } else if (currentIndex == (int)levels.size()) { // mute
                         isMuted = !isMuted;
                         if (isMuted) {
                             Mix_VolumeMusic(0);
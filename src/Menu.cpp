@@ -2,18 +2,13 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
-Menu::Menu(SDL_Renderer* renderer, const char* fontPath, int fontSize)
-: renderer_(renderer)
+Menu::Menu(SDL_Renderer* renderer, TTF_Font* font)
+: renderer_(renderer), font_(font)
 {
-    font_ = TTF_OpenFont(fontPath, fontSize);
-    if(!font_){
-        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "TTF_OpenFont failed: %s", TTF_GetError());
-    }
 }
 
 Menu::~Menu(){
     destroyTextures();
-    if(font_) TTF_CloseFont(font_);
 }
 
 void Menu::createLabelTexture(Item &it){
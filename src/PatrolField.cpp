@@ -0,0 +1,56 @@
+#include "PatrolField.h"
+#include <algorithm>
+
+// Values of a cell from its neighbour's values one step closer to the row start/end.
+// Past the edge of the grid there is no ground and no known wall.
+static inline void stepEdge(bool solid, uint8_t prevEdge, uint8_t prevWall, uint8_t& edge, uint8_t& wall) {
+    edge = solid ? (uint8_t)std::min(PatrolField::MAX_DIST, prevEdge + 1) : 0;
+    wall = solid ? 0 : (uint8_t)std::min(PatrolField::MAX_DIST, prevWall + 1);
+}
+
+void PatrolField::rebuild(const SolidBits& solid) {
+    rows = solid.rowCount();
+    cols = solid.colCount();
+    cells.assign((size_t)rows * cols, PatrolCell{ 0, 0, MAX_DIST, MAX_DIST });
+    for (int r = 0; r < rows; ++r) {
+        PatrolCell* row = &cells[(size_t)r * cols];
+        uint8_t edge = 0, wall = MAX_DIST;
+        for (int c = 0; c < cols; ++c) {
+            stepEdge(solid.test(r, c), edge, wall, edge, wall);
+            row[c].edgeLeft = edge;
+            row[c].wallLeft = wall;
+        }
+        edge = 0;
+        wall = MAX_DIST;
+        for (int c = cols - 1; c >= 0; --c) {
+            stepEdge(solid.test(r, c), edge, wall, edge, wall);
+            row[c].edgeRight = edge;
+            row[c].wallRight = wall;
+        }
+    }
+}
+
+void PatrolField::update(const SolidBits& solid, int r, int c) {
+    if ((unsigned)r >= (unsigned)rows || (unsigned)c >= (unsigned)cols) return;
+    PatrolCell* row = &cells[(size_t)r * cols];
+
+    // Left values depend on the cells to the left, so the change spreads rightwards
+    // until a cell comes out the same as before
+    uint8_t edge = c > 0 ? row[c - 1].edgeLeft : 0;
+    uint8_t wall = c > 0 ? row[c - 1].wallLeft : MAX_DIST;
+    for (int x = c; x < cols; ++x) {
+        stepEdge(solid.test(r, x), edge, wall, edge, wall);
+        if (x > c && row[x].edgeLeft == edge && row[x].wallLeft == wall) break;
+        row[x].edgeLeft = edge;
+        row[x].wallLeft = wall;
+    }
+
+    edge = c + 1 < cols ? row[c + 1].edgeRight : 0;
+    wall = c + 1 < cols ? row[c + 1].wallRight : MAX_DIST;
+    for (int x = c; x >= 0; --x) {
+        stepEdge(solid.test(r, x), edge, wall, edge, wall);
+        if (x < c && row[x].edgeRight == edge && row[x].wallRight == wall) break;
+        row[x].edgeRight = edge;
+        row[x].wallRight = wall;
+    }
+}
@@ -49,16 +49,12 @@ void Player::update(double dt, const Uint8* kb){
     }
 }
 
-void Player::render(SDL_Renderer* r, int camX, int camY, float renderScale){
-    if(!r) return;
+void Player::render(SpriteBatch& batch, int camX, int camY, float renderScale, float alpha){
     if(frames.empty()) return;
     Texture* t = frames[curFrame];
     if(!t || !t->tex) return;
 
-    SDL_SetTextureBlendMode(t->tex, SDL_BLENDMODE_BLEND);
-
-    int srcW = 0, srcH = 0;
-    SDL_QueryTexture(t->tex, nullptr, nullptr, &srcW, &srcH);
+    int srcW = t->w, srcH = t->h;
     if (srcH == 0) return;
 
     int baseW = (width > 0) ? width : srcW;
@@ -67,10 +63,12 @@ void Player::render(SDL_Renderer* r, int camX, int camY, float renderScale){
     int destW = (int)(baseW * renderScale + 0.5f);
     int destH = (int)(baseH * renderScale + 0.5f);
 
-    int dstX = (int)((x - camX) * renderScale + 0.5f);
-    int dstY = (int)((y - camY - baseH) * renderScale + 0.5f);
+    float drawX = prevX + (x - prevX) * alpha;
+    float drawY = prevY + (y - prevY) * alpha;
+    int dstX = (int)((drawX - camX) * renderScale + 0.5f);
+    int dstY = (int)((drawY - camY - baseH) * renderScale + 0.5f);
 
     SDL_Rect dst{ dstX, dstY, destW, destH };
     SDL_RendererFlip flip = facingLeft ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-    SDL_RenderCopyEx(r, t->tex, nullptr, &dst, 0.0, nullptr, flip);
+    batch.draw(*t, dst, flip);
 }
\ No newline at end of file
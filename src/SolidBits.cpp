@@ -0,0 +1,71 @@
+#include "SolidBits.h"
+#include <algorithm>
+
+// Mask of bits lo..63 / 0..hi of a word
+static inline uint64_t maskFrom(int lo) { return ~0ull << lo; }
+static inline uint64_t maskTo(int hi) { return ~0ull >> (63 - hi); }
+
+void SolidBits::reset(int newRows, int newCols) {
+    rows = std::max(0, newRows);
+    cols = std::max(0, newCols);
+    rowWords = (cols + 63) / 64;
+    colWords = (rows + 63) / 64;
+    rowBits.assign((size_t)rows * rowWords, 0);
+    colBits.assign((size_t)cols * colWords, 0);
+}
+
+void SolidBits::set(int r, int c, bool solid) {
+    if ((unsigned)r >= (unsigned)rows || (unsigned)c >= (unsigned)cols) return;
+    uint64_t& rw = rowBits[(size_t)r * rowWords + (c >> 6)];
+    uint64_t& cw = colBits[(size_t)c * colWords + (r >> 6)];
+    if (solid) {
+        rw |= 1ull << (c & 63);
+        cw |= 1ull << (r & 63);
+    } else {
+        rw &= ~(1ull << (c & 63));
+        cw &= ~(1ull << (r & 63));
+    }
+}
+
+int SolidBits::firstIn(const uint64_t* words, int lo, int hi) {
+    int w = lo >> 6, wEnd = hi >> 6;
+    uint64_t bits = words[w] & maskFrom(lo & 63);
+    while (true) {
+        if (w == wEnd) bits &= maskTo(hi & 63);
+        if (bits) return (w << 6) + countTrailingZeros64(bits);
+        if (++w > wEnd) return -1;
+        bits = words[w];
+    }
+}
+
+int SolidBits::lastIn(const uint64_t* words, int lo, int hi) {
+    int w = hi >> 6, wEnd = lo >> 6;
+    uint64_t bits = words[w] & maskTo(hi & 63);
+    while (true) {
+        if (w == wEnd) bits &= maskFrom(lo & 63);
+        if (bits) return (w << 6) + 63 - countLeadingZeros64(bits);
+        if (--w < wEnd) return -1;
+        bits = words[w];
+    }
+}
+
+int SolidBits::firstInRow(int r, int c0, int c1) const {
+    c0 = std::max(c0, 0);
+    c1 = std::min(c1, cols - 1);
+    if ((unsigned)r >= (unsigned)rows || c0 > c1) return -1;
+    return firstIn(&rowBits[(size_t)r * rowWords], c0, c1);
+}
+
+int SolidBits::lastInRow(int r, int c0, int c1) const {
+    c0 = std::max(c0, 0);
+    c1 = std::min(c1, cols - 1);
+    if ((unsigned)r >= (unsigned)rows || c0 > c1) return -1;
+    return lastIn(&rowBits[(size_t)r * rowWords], c0, c1);
+}
+
+int SolidBits::firstInCol(int c, int r0, int r1) const {
+    r0 = std::max(r0, 0);
+    r1 = std::min(r1, rows - 1);
+    if ((unsigned)c >= (unsigned)cols || r0 > r1) return -1;
+    return firstIn(&colBits[(size_t)c * colWords], r0, r1);
+}
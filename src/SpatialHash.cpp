@@ -0,0 +1,33 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+SpatialHash::SpatialHash(float cellSize, int bucketCount) {
+    invCellSize = 1.0f / (cellSize > 1.0f ? cellSize : 1.0f);
+    size_t buckets = 1;
+    while (buckets < (size_t)(bucketCount > 1 ? bucketCount : 1)) buckets <<= 1;
+    bucketMask = buckets - 1;
+    for (auto& h : heads) h.assign(buckets, -1);
+}
+
+void SpatialHash::clear() {
+    for (auto& h : heads) std::fill(h.begin(), h.end(), -1);
+    nodes.clear();
+    items.clear();
+}
+
+void SpatialHash::insert(Kind kind, int index, float left, float top, float w, float h) {
+    int item = (int)items.size();
+    items.push_back({ left, top, left + w, top + h, index, 0, kind });
+    std::vector<int>& kindHeads = heads[slotOf(kind)];
+    int cx0 = cellOf(left), cx1 = cellOf(left + w);
+    int cy0 = cellOf(top), cy1 = cellOf(top + h);
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            size_t b = bucketOf(cx, cy);
+            // Distinct cells hashing to the bucket this item was just added to need no second node
+            if (kindHeads[b] >= 0 && nodes[kindHeads[b]].item == item) continue;
+            nodes.push_back({ item, kindHeads[b] });
+            kindHeads[b] = (int)nodes.size() - 1;
+        }
+    }
+}
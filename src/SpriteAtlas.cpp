@@ -0,0 +1,146 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+#include <cstdint>
+
+SpriteAtlas::~SpriteAtlas() {
+    // The Textures in placed may already be gone, only the atlas' own resources are freed
+    placed.clear();
+    clear();
+}
+
+// Box filter: every source pixel under a target pixel counts once, colour weighted by
+// alpha so the transparent surroundings don't darken the sprite's edges
+SDL_Surface* SpriteAtlas::scaleToHeight(SDL_Surface* src, int maxH, const std::string& name) {
+    SDL_Surface* in = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!in) {
+        SDL_Log("SDL_ConvertSurfaceFormat failed for %s: %s", name.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    if (maxH <= 0 || in->h <= maxH) return in;
+
+    int dstH = maxH;
+    int dstW = std::max(1, (int)((long long)in->w * maxH / in->h));
+    SDL_Surface* out = SDL_CreateRGBSurfaceWithFormat(0, dstW, dstH, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!out) {
+        SDL_Log("SDL_CreateRGBSurfaceWithFormat failed for %s: %s", name.c_str(), SDL_GetError());
+        return in;
+    }
+
+    for (int y = 0; y < dstH; ++y) {
+        int y0 = y * in->h / dstH;
+        int y1 = std::max(y0 + 1, (y + 1) * in->h / dstH);
+        uint8_t* dst = static_cast<uint8_t*>(out->pixels) + (size_t)y * out->pitch;
+        for (int x = 0; x < dstW; ++x) {
+            int x0 = x * in->w / dstW;
+            int x1 = std::max(x0 + 1, (x + 1) * in->w / dstW);
+            uint32_t r = 0, g = 0, b = 0, a = 0;
+            for (int sy = y0; sy < y1; ++sy) {
+                const uint8_t* p = static_cast<const uint8_t*>(in->pixels) + (size_t)sy * in->pitch + (size_t)x0 * 4;
+                for (int sx = x0; sx < x1; ++sx, p += 4) {
+                    r += p[0] * p[3];
+                    g += p[1] * p[3];
+                    b += p[2] * p[3];
+                    a += p[3];
+                }
+            }
+            uint32_t n = (uint32_t)((y1 - y0) * (x1 - x0));
+            uint8_t* o = dst + (size_t)x * 4;
+            o[0] = a ? (uint8_t)((r + a / 2) / a) : 0;
+            o[1] = a ? (uint8_t)((g + a / 2) / a) : 0;
+            o[2] = a ? (uint8_t)((b + a / 2) / a) : 0;
+            o[3] = (uint8_t)((a + n / 2) / n);
+        }
+    }
+    SDL_FreeSurface(in);
+    return out;
+}
+
+void SpriteAtlas::add(Texture& target, SDL_Surface* image, const std::string& name) {
+    if (!image) return;
+    entries.push_back({ &target, image, name, { 0, 0, image->w, image->h }, -1 });
+}
+
+bool SpriteAtlas::build(SDL_Renderer* r) {
+    if (!r) return false;
+
+    int pageSize = MAX_PAGE_SIZE;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(r, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0) {
+        pageSize = std::min(pageSize, std::min(info.max_texture_width, info.max_texture_height));
+    }
+
+    // Shelf packing, tallest first so each shelf wastes little height
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return entries[a].rect.h > entries[b].rect.h; });
+
+    std::vector<int> pageHeights;
+    int shelfX = 0, shelfY = 0, shelfH = 0;
+    for (size_t i : order) {
+        Entry& e = entries[i];
+        int w = e.rect.w + 2 * PAD, h = e.rect.h + 2 * PAD;
+        if (w > pageSize || h > pageSize) continue; // gets its own texture
+        if (pageHeights.empty() || shelfX + w > pageSize) {
+            shelfY += shelfH;
+            shelfX = 0;
+            shelfH = 0;
+        }
+        if (pageHeights.empty() || shelfY + h > pageSize) {
+            pageHeights.push_back(0);
+            shelfX = shelfY = shelfH = 0;
+        }
+        e.page = (int)pageHeights.size() - 1;
+        e.rect.x = shelfX + PAD;
+        e.rect.y = shelfY + PAD;
+        shelfX += w;
+        shelfH = std::max(shelfH, h);
+        pageHeights.back() = std::max(pageHeights.back(), shelfY + h);
+    }
+
+    const size_t firstPage = pages.size();
+    for (size_t p = 0; p < pageHeights.size(); ++p) {
+        SDL_Texture* page = nullptr;
+        SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageHeights[p], 32, SDL_PIXELFORMAT_RGBA32);
+        if (surf) {
+            for (Entry& e : entries) {
+                if (e.page != (int)p) continue;
+                // Copy the pixels as they are, then give the caller's surface its mode back
+                SDL_Rect dst = e.rect;
+                SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+                SDL_GetSurfaceBlendMode(e.image, &mode);
+                SDL_SetSurfaceBlendMode(e.image, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(e.image, nullptr, surf, &dst);
+                SDL_SetSurfaceBlendMode(e.image, mode);
+            }
+            page = SDL_CreateTextureFromSurface(r, surf);
+            SDL_FreeSurface(surf);
+        }
+        if (page) SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+        else SDL_Log("Sprite atlas page %d failed: %s", (int)(firstPage + p), SDL_GetError());
+        pages.push_back(page); // kept even when null so entry page numbers stay valid
+    }
+
+    bool ok = true;
+    for (Entry& e : entries) {
+        SDL_Texture* page = e.page >= 0 ? pages[firstPage + e.page] : nullptr;
+        if (page) {
+            e.target->setRegion(page, e.rect);
+            placed.push_back(e.target);
+        } else if (!e.target->loadFromSurface(r, e.image, e.name)) ok = false;
+    }
+    entries.clear();
+    return ok;
+}
+
+void SpriteAtlas::clear() {
+    entries.clear();
+    for (Texture* t : placed) {
+        if (t->tex && std::find(pages.begin(), pages.end(), t->tex) != pages.end()) t->setRegion(nullptr, SDL_Rect{ 0, 0, 0, 0 });
+    }
+    placed.clear();
+    for (SDL_Texture* page : pages) {
+        if (page) SDL_DestroyTexture(page);
+    }
+    pages.clear();
+}
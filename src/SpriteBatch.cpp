@@ -0,0 +1,108 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+void SpriteBatch::begin(const SDL_Rect& viewRect) {
+    view = viewRect;
+    quads.clear();
+    groups.clear();
+}
+
+void SpriteBatch::draw(SDL_Texture* tex, const SDL_Rect& src, const SDL_Rect& dst, SDL_RendererFlip flip, SDL_Color tint) {
+    if (!tex || dst.w <= 0 || dst.h <= 0) return;
+    if (!SDL_HasIntersection(&dst, &view)) return;
+    // A frame uses a handful of textures, the most recent one almost every time
+    int group = (int)groups.size() - 1;
+    while (group >= 0 && groups[group] != tex) --group;
+    if (group < 0) {
+        group = (int)groups.size();
+        groups.push_back(tex);
+    }
+    quads.push_back({ group, src, dst, flip, tint });
+}
+
+void SpriteBatch::draw(const Texture& tex, const SDL_Rect& dst, SDL_RendererFlip flip, SDL_Color tint) {
+    draw(tex.tex, tex.src, dst, flip, tint);
+}
+
+void SpriteBatch::fill(const SDL_Rect& dst, SDL_Color color) {
+    if (dst.w <= 0 || dst.h <= 0) return;
+    if (!SDL_HasIntersection(&dst, &view)) return;
+    int group = (int)groups.size() - 1;
+    while (group >= 0 && groups[group] != nullptr) --group;
+    if (group < 0) {
+        group = (int)groups.size();
+        groups.push_back(nullptr);
+    }
+    quads.push_back({ group, SDL_Rect{ 0, 0, 0, 0 }, dst, SDL_FLIP_NONE, color });
+}
+
+// One copy per quad, for renderers or SDL versions without geometry support
+void SpriteBatch::drawEach(SDL_Renderer* r, SDL_Texture* tex, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const Quad& q = quads[i];
+        if (!tex) {
+            SDL_SetRenderDrawColor(r, q.color.r, q.color.g, q.color.b, q.color.a);
+            SDL_RenderFillRect(r, &q.dst);
+        } else {
+            SDL_SetTextureColorMod(tex, q.color.r, q.color.g, q.color.b);
+            SDL_SetTextureAlphaMod(tex, q.color.a);
+            SDL_RenderCopyEx(r, tex, &q.src, &q.dst, 0.0, nullptr, q.flip);
+        }
+        ++lastDrawCalls;
+    }
+    if (tex) {
+        SDL_SetTextureColorMod(tex, 255, 255, 255);
+        SDL_SetTextureAlphaMod(tex, 255);
+    }
+}
+
+void SpriteBatch::flush(SDL_Renderer* r) {
+    lastDrawCalls = 0;
+    if (r && !quads.empty()) {
+        std::stable_sort(quads.begin(), quads.end(), [](const Quad& a, const Quad& b) { return a.group < b.group; });
+
+        for (size_t begin = 0; begin < quads.size();) {
+            size_t end = begin;
+            while (end < quads.size() && quads[end].group == quads[begin].group) ++end;
+            SDL_Texture* tex = groups[quads[begin].group];
+
+            bool drawn = false;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+            float invW = 1.0f, invH = 1.0f;
+            int texW = 0, texH = 0;
+            if (!tex || (SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH) == 0 && texW > 0 && texH > 0)) {
+                if (tex) {
+                    invW = 1.0f / texW;
+                    invH = 1.0f / texH;
+                }
+                vertices.clear();
+                indices.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    const Quad& q = quads[i];
+                    float x0 = (float)q.dst.x, y0 = (float)q.dst.y;
+                    float x1 = x0 + q.dst.w, y1 = y0 + q.dst.h;
+                    float u0 = q.src.x * invW, v0 = q.src.y * invH;
+                    float u1 = (q.src.x + q.src.w) * invW, v1 = (q.src.y + q.src.h) * invH;
+                    if (q.flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+                    if (q.flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+                    int base = (int)vertices.size();
+                    vertices.push_back({ { x0, y0 }, q.color, { u0, v0 } });
+                    vertices.push_back({ { x1, y0 }, q.color, { u1, v0 } });
+                    vertices.push_back({ { x1, y1 }, q.color, { u1, v1 } });
+                    vertices.push_back({ { x0, y1 }, q.color, { u0, v1 } });
+                    int quadIndices[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+                    indices.insert(indices.end(), quadIndices, quadIndices + 6);
+                }
+                drawn = SDL_RenderGeometry(r, tex, vertices.data(), (int)vertices.size(),
+                                           indices.data(), (int)indices.size()) == 0;
+                if (drawn) ++lastDrawCalls;
+            }
+#endif
+            if (!drawn) drawEach(r, tex, begin, end);
+            begin = end;
+        }
+    }
+    quads.clear();
+    groups.clear();
+}
@@ -5,38 +5,66 @@
 #include <iostream>
 
 Texture::~Texture() {
-    if (tex) {
-        SDL_DestroyTexture(tex);
-        tex = nullptr;
-    }
+    release();
 }
 
-bool Texture::load(SDL_Renderer* renderer, const std::string& path) {
-    if (!renderer) return false;
+void Texture::release() {
+    if (tex && owned) SDL_DestroyTexture(tex);
+    tex = nullptr;
+    owned = false;
+    w = h = 0;
+    src = { 0, 0, 0, 0 };
+}
 
-    if (tex) {
-        SDL_DestroyTexture(tex);
-        tex = nullptr;
-        w = h = 0;
+void Texture::setRegion(SDL_Texture* page, const SDL_Rect& rect) {
+    release();
+    tex = page;
+    src = rect;
+    w = rect.w;
+    h = rect.h;
+}
+
+static SDL_Surface* toRGBA32(SDL_Surface* surf, const std::string& name) {
+    SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surf);
+    if (!conv) {
+        SDL_Log("SDL_ConvertSurfaceFormat failed for %s: %s", name.c_str(), SDL_GetError());
     }
+    return conv;
+}
 
+SDL_Surface* Texture::decodeFile(const std::string& path) {
     SDL_Surface* surf = IMG_Load(path.c_str());
     if (!surf) {
         SDL_Log("IMG_Load failed for %s: %s", path.c_str(), IMG_GetError());
-        return false;
+        return nullptr;
     }
+    return toRGBA32(surf, path);
+}
 
-    SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
-    SDL_FreeSurface(surf);
-    if (!conv) {
-        SDL_Log("SDL_ConvertSurfaceFormat failed for %s: %s", path.c_str(), SDL_GetError());
-        return false;
+SDL_Surface* Texture::decodeMemory(const void* data, size_t size, const std::string& name) {
+    if (!data || size == 0) return nullptr;
+    SDL_RWops* rw = SDL_RWFromConstMem(data, (int)size);
+    if (!rw) {
+        SDL_Log("SDL_RWFromConstMem failed for %s: %s", name.c_str(), SDL_GetError());
+        return nullptr;
     }
+    SDL_Surface* surf = IMG_Load_RW(rw, 1); // closes rw
+    if (!surf) {
+        SDL_Log("IMG_Load_RW failed for %s: %s", name.c_str(), IMG_GetError());
+        return nullptr;
+    }
+    return toRGBA32(surf, name);
+}
+
+bool Texture::loadFromSurface(SDL_Renderer* renderer, SDL_Surface* surf, const std::string& name) {
+    if (!renderer || !surf) return false;
+
+    release();
 
-    SDL_Texture* newTex = SDL_CreateTextureFromSurface(renderer, conv);
+    SDL_Texture* newTex = SDL_CreateTextureFromSurface(renderer, surf);
     if (!newTex) {
-        SDL_Log("SDL_CreateTextureFromSurface failed for %s: %s", path.c_str(), SDL_GetError());
-        SDL_FreeSurface(conv);
+        SDL_Log("SDL_CreateTextureFromSurface failed for %s: %s", name.c_str(), SDL_GetError());
         return false;
     }
 
@@ -44,17 +72,37 @@ bool Texture::load(SDL_Renderer* renderer, const std::string& path) {
 
     int texW = 0, texH = 0;
     if (SDL_QueryTexture(newTex, nullptr, nullptr, &texW, &texH) != 0) {
-        SDL_Log("SDL_QueryTexture failed for %s: %s", path.c_str(), SDL_GetError());
+        SDL_Log("SDL_QueryTexture failed for %s: %s", name.c_str(), SDL_GetError());
     }
 
     tex = newTex;
+    owned = true;
     w = texW;
     h = texH;
+    src = { 0, 0, w, h };
+
+    SDL_Log("DBG: Texture loaded: %s (%dx%d)", name.c_str(), w, h);
+    return true;
+}
+
+bool Texture::load(SDL_Renderer* renderer, const std::string& path) {
+    if (!renderer) return false;
 
+    SDL_Surface* conv = decodeFile(path);
+    if (!conv) return false;
+    bool ok = loadFromSurface(renderer, conv, path);
     SDL_FreeSurface(conv);
+    return ok;
+}
 
-    SDL_Log("DBG: Texture loaded: %s (%dx%d)", path.c_str(), w, h);
-    return true;
+bool Texture::loadFromMemory(SDL_Renderer* renderer, const void* data, size_t size, const std::string& name) {
+    if (!renderer) return false;
+
+    SDL_Surface* conv = decodeMemory(data, size, name);
+    if (!conv) return false;
+    bool ok = loadFromSurface(renderer, conv, name);
+    SDL_FreeSurface(conv);
+    return ok;
 }
 
 void Texture::draw(SDL_Renderer* renderer, int x, int y, int drawW, int drawH) {
@@ -66,5 +114,5 @@ void Texture::draw(SDL_Renderer* renderer, int x, int y, int drawW, int drawH) {
     if (dstW <= 0 || dstH <= 0) return;
 
     SDL_Rect dst{ x, y, dstW, dstH };
-    SDL_RenderCopy(renderer, tex, nullptr, &dst);
-}
\ No newline at end of file
+    SDL_RenderCopy(renderer, tex, &src, &dst);
+}
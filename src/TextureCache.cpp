@@ -0,0 +1,44 @@
+#include "TextureCache.h"
+#include "Hash.h"
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+Texture* TextureCache::fromMemory(SDL_Renderer* r, const void* data, size_t size, const std::string& name) {
+    if (!data || size == 0) return nullptr;
+    uint64_t key = hashBytes(data, size);
+    auto it = textures.find(key);
+    if (it != textures.end()) return it->second.get();
+
+    auto tex = std::make_unique<Texture>();
+    if (!tex->loadFromMemory(r, data, size, name)) return nullptr;
+    Texture* result = tex.get();
+    textures[key] = std::move(tex);
+    return result;
+}
+
+Texture* TextureCache::fromFile(SDL_Renderer* r, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        SDL_Log("TextureCache: cannot open %s", path.c_str());
+        return nullptr;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return fromMemory(r, bytes.data(), bytes.size(), path);
+}
+
+Texture* TextureCache::fromSurface(SDL_Renderer* r, uint64_t key, SDL_Surface* surf, const std::string& name) {
+    auto it = textures.find(key);
+    if (it != textures.end()) return it->second.get();
+    if (!surf) return nullptr;
+
+    auto tex = std::make_unique<Texture>();
+    if (!tex->loadFromSurface(r, surf, name)) return nullptr;
+    Texture* result = tex.get();
+    textures[key] = std::move(tex);
+    return result;
+}
+
+void TextureCache::clear() {
+    textures.clear();
+}
@@ -0,0 +1,154 @@
+#include "TileLayerCache.h"
+#include <algorithm>
+
+TileLayerCache::~TileLayerCache() {
+    clear();
+}
+
+void TileLayerCache::setTextures(const Texture* const* tileTextures) {
+    textures = tileTextures;
+    valid = false;
+}
+
+void TileLayerCache::clear() {
+    for (Chunk& ch : chunks) {
+        if (ch.tex) SDL_DestroyTexture(ch.tex);
+    }
+    chunks.clear();
+    valid = false;
+}
+
+void TileLayerCache::markDirty(int r, int c) {
+    int cy = r / CHUNK_ROWS, cx = c / CHUNK_COLS;
+    for (Chunk& ch : chunks) {
+        if (ch.cy == cy && ch.cx == cx) ch.dirty = true;
+    }
+}
+
+TileLayerCache::Chunk* TileLayerCache::acquire(SDL_Renderer* ren, int cy, int cx) {
+    for (Chunk& ch : chunks) {
+        if (ch.cy == cy && ch.cx == cx) return &ch;
+    }
+    Chunk* slot = nullptr;
+    if ((int)chunks.size() < MAX_CHUNKS) {
+        SDL_Texture* tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                             CHUNK_COLS * cellW, CHUNK_ROWS * cellH);
+        if (!tex) {
+            SDL_Log("Tile chunk texture failed: %s", SDL_GetError());
+            return nullptr;
+        }
+        // Blending sprites onto a clear target leaves premultiplied colour, so composite it as
+        // such; renderers without custom blend modes get plain blending and slightly dark edges
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if (SDL_SetTextureBlendMode(tex, premultiplied) != 0) SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        chunks.push_back({ cy, cx, tex, true, frame });
+        slot = &chunks.back();
+    } else {
+        slot = &*std::min_element(chunks.begin(), chunks.end(),
+                                  [](const Chunk& a, const Chunk& b) { return a.lastUsed < b.lastUsed; });
+    }
+    slot->cy = cy;
+    slot->cx = cx;
+    slot->dirty = true;
+    return slot;
+}
+
+void TileLayerCache::drawCells(SDL_Renderer* ren, const Level& level, int r0, int r1, int c0, int c1,
+                               int originX, int originY, bool drawEditorTiles) const {
+    // Only resident cells hold tiles, the rest read as empty
+    int firstRow = std::max(level.gridRow0, r0);
+    int lastRow = std::min(level.gridRow0 + level.gridRows - 1, r1);
+    int firstCol = std::max(level.gridCol0, c0);
+    int lastCol = std::min(level.gridCol0 + level.gridCols - 1, c1);
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            const Tiles::Info& info = Tiles::info(level.tileUnchecked(r, c));
+            if (info.draw == Tiles::DRAW_NONE) continue;
+
+            int x = originX + (c - c0) * cellW;
+            int y = originY + (r - r0) * cellH;
+
+            if (info.draw == Tiles::DRAW_SPRITE) {
+                int t = ((r + c) & 1) ? info.altTexture : info.texture;
+                if (!textures || !textures[t] || !textures[t]->tex) continue;
+                SDL_Rect dst = spriteRects[t];
+                dst.x += x;
+                dst.y += y;
+                SDL_RenderCopy(ren, textures[t]->tex, &textures[t]->src, &dst);
+            } else if (info.draw == Tiles::DRAW_FILL || drawEditorTiles) {
+                SDL_Rect dst{ x, y, cellW, cellH };
+                SDL_SetRenderDrawColor(ren, info.r, info.g, info.b, 255);
+                SDL_RenderFillRect(ren, &dst);
+            }
+        }
+    }
+}
+
+void TileLayerCache::render(SDL_Renderer* ren, Level& level, int camX, int camY, int viewW, int viewH,
+                            int newCellW, int newCellH, bool newEditMode) {
+    if (!ren || newCellW <= 0 || newCellH <= 0) return;
+    ++frame;
+
+    if (!valid || level.layoutRevision() != revision || newCellW != cellW || newCellH != cellH || newEditMode != editMode) {
+        if (newCellW != cellW || newCellH != cellH) {
+            // Chunk textures are sized by the cell size
+            clear();
+            cellW = newCellW;
+            cellH = newCellH;
+        }
+        // Sprite placement inside a cell for each tile texture
+        for (int t = 0; t < Tiles::TEX_COUNT; ++t) {
+            spriteRects[t] = {};
+            const Texture* tex = textures ? textures[t] : nullptr;
+            if (!tex || !tex->tex || tex->h <= 0) continue;
+            int renderW = (int)(cellH * ((float)tex->w / tex->h) + 0.5f);
+            spriteRects[t] = { (cellW - renderW) / 2, 0, renderW, cellH };
+        }
+        for (Chunk& ch : chunks) ch.dirty = true;
+        revision = level.layoutRevision();
+        editMode = newEditMode;
+        valid = true;
+    }
+    level.takeTileEdits(edits);
+    for (const auto& e : edits) markDirty(e.first, e.second);
+
+    int firstRow = std::max(0, camY / cellH);
+    int lastRow = std::min(level.rows - 1, (camY + viewH) / cellH);
+    int firstCol = std::max(0, camX / cellW);
+    int lastCol = std::min(level.cols - 1, (camX + viewW) / cellW);
+    if (firstRow > lastRow || firstCol > lastCol) return;
+
+    if (!SDL_RenderTargetSupported(ren)) {
+        drawCells(ren, level, firstRow, lastRow, firstCol, lastCol,
+                  firstCol * cellW - camX, firstRow * cellH - camY, editMode);
+        return;
+    }
+
+    const int chunkW = CHUNK_COLS * cellW, chunkH = CHUNK_ROWS * cellH;
+    for (int cy = firstRow / CHUNK_ROWS; cy <= lastRow / CHUNK_ROWS; ++cy) {
+        for (int cx = firstCol / CHUNK_COLS; cx <= lastCol / CHUNK_COLS; ++cx) {
+            Chunk* ch = acquire(ren, cy, cx);
+            if (!ch) {
+                // Out of texture memory: fall back to drawing this chunk's cells
+                drawCells(ren, level, cy * CHUNK_ROWS, cy * CHUNK_ROWS + CHUNK_ROWS - 1,
+                          cx * CHUNK_COLS, cx * CHUNK_COLS + CHUNK_COLS - 1,
+                          cx * chunkW - camX, cy * chunkH - camY, editMode);
+                continue;
+            }
+            ch->lastUsed = frame;
+            if (ch->dirty) {
+                SDL_SetRenderTarget(ren, ch->tex);
+                SDL_SetRenderDrawColor(ren, 0, 0, 0, 0);
+                SDL_RenderClear(ren);
+                drawCells(ren, level, cy * CHUNK_ROWS, cy * CHUNK_ROWS + CHUNK_ROWS - 1,
+                          cx * CHUNK_COLS, cx * CHUNK_COLS + CHUNK_COLS - 1, 0, 0, editMode);
+                SDL_SetRenderTarget(ren, nullptr);
+                ch->dirty = false;
+            }
+            SDL_Rect dst{ cx * chunkW - camX, cy * chunkH - camY, chunkW, chunkH };
+            SDL_RenderCopy(ren, ch->tex, nullptr, &dst);
+        }
+    }
+}
@@ -3,80 +3,181 @@ extern "C" {
 #include "zip.h" // minizip
 #include "unzip.h"
 }
+#include <SDL.h>
 #include <cstring>
-#include <fstream>
+#include <filesystem>
 #include <vector>
 
-bool saveLevelZip(const std::string& zipPath, const std::string& layout, const std::string& assets, const std::string& backgroundPath){
-    zipFile zf = zipOpen(zipPath.c_str(), 0);
-    if(!zf) return false;
+ZipWriter::~ZipWriter() {
+    close();
+}
 
-    zip_fileinfo zi{};
+bool ZipWriter::open(const std::string& path) {
+    close();
+    ok = true;
+    handle = zipOpen(path.c_str(), 0);
+    return handle != nullptr;
+}
 
-    // Add layout.txt
-    if(zipOpenNewFileInZip(zf, "layout.txt", &zi, nullptr,0,nullptr,0,nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION) != ZIP_OK){
-        zipClose(zf, nullptr); return false;
+bool ZipWriter::add(const std::string& name, const void* data, size_t size) {
+    if (!handle) return false;
+    zipFile zf = static_cast<zipFile>(handle);
+    zip_fileinfo zi{};
+    if (zipOpenNewFileInZip(zf, name.c_str(), &zi, nullptr,0,nullptr,0,nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION) != ZIP_OK) {
+        ok = false;
+        return false;
     }
-    zipWriteInFileInZip(zf, layout.data(), (unsigned)layout.size());
-    zipCloseFileInZip(zf);
+    if (zipWriteInFileInZip(zf, data, (unsigned)size) != ZIP_OK) ok = false;
+    if (zipCloseFileInZip(zf) != ZIP_OK) ok = false;
+    return ok;
+}
 
-    // Add assets.txt
-    if(zipOpenNewFileInZip(zf, "assets.txt", &zi, nullptr,0,nullptr,0,nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION) != ZIP_OK){
-        zipClose(zf, nullptr); return false;
-    }
-    zipWriteInFileInZip(zf, assets.data(), (unsigned)assets.size());
-    zipCloseFileInZip(zf);
-
-    // Add background file if exists
-    std::ifstream bgFile(backgroundPath, std::ios::binary);
-    if (bgFile) {
-        std::string bgData((std::istreambuf_iterator<char>(bgFile)), std::istreambuf_iterator<char>());
-        std::string bgFilename = backgroundPath.substr(backgroundPath.find_last_of("/\\") + 1);
-        if(zipOpenNewFileInZip(zf, bgFilename.c_str(), &zi, nullptr,0,nullptr,0,nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION) != ZIP_OK){
-            zipClose(zf, nullptr); return false;
-        }
-        zipWriteInFileInZip(zf, bgData.data(), (unsigned)bgData.size());
-        zipCloseFileInZip(zf);
+bool ZipWriter::close() {
+    if (!handle) return false;
+    if (zipClose(static_cast<zipFile>(handle), nullptr) != ZIP_OK) ok = false;
+    handle = nullptr;
+    return ok;
+}
+
+bool saveLevelZip(const std::string& zipPath, const std::string& layoutName, const std::string& layout, const std::string& assets,
+                  const std::string& backgroundName, const std::vector<char>& backgroundData,
+                  const std::function<bool(ZipWriter&)>& writeExtra){
+    ZipWriter zip;
+    if(!zip.open(zipPath)) return false;
+
+    // Add layout (layout.bin or layout.txt) and assets.txt
+    if(!zip.add(layoutName, layout.data(), layout.size())) { zip.close(); return false; }
+    if(!zip.add(ASSETS_ENTRY, assets.data(), assets.size())) { zip.close(); return false; }
+
+    // Add background file if there is one
+    if (!backgroundData.empty() && !backgroundName.empty()) {
+        if(!zip.add(backgroundName, backgroundData.data(), backgroundData.size())) { zip.close(); return false; }
     }
 
-    zipClose(zf, nullptr);
+    if (writeExtra && !writeExtra(zip)) { zip.close(); return false; }
+
+    return zip.close();
+}
+
+bool replaceFile(const std::string& from, const std::string& target) {
+    std::error_code ec;
+    std::filesystem::rename(from, target, ec);
+    if (ec) {
+        SDL_Log("Failed to replace %s: %s", target.c_str(), ec.message().c_str());
+        std::filesystem::remove(from, ec);
+        return false;
+    }
     return true;
 }
 
-bool loadLevelZip(const std::string& zipPath, std::string& layout, std::string& assets) {
-    unzFile uf = unzOpen(zipPath.c_str());
+ZipReader::~ZipReader() {
+    close();
+}
+
+ZipReader::ZipReader(ZipReader&& other) noexcept
+    : handle(other.handle), entries(std::move(other.entries)) {
+    other.handle = nullptr;
+}
+
+ZipReader& ZipReader::operator=(ZipReader&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        entries = std::move(other.entries);
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+bool ZipReader::open(const std::string& path) {
+    close();
+    unzFile uf = unzOpen(path.c_str());
     if (!uf) return false;
 
-    // Extract layout.txt
-    if (unzLocateFile(uf, "layout.txt", 0) == UNZ_OK) {
-        unz_file_info fileInfo;
-        if (unzGetCurrentFileInfo(uf, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK) {
-            if (unzOpenCurrentFile(uf) == UNZ_OK) {
-                std::vector<char> buffer(fileInfo.uncompressed_size);
-                int read = unzReadCurrentFile(uf, buffer.data(), fileInfo.uncompressed_size);
-                if (read == fileInfo.uncompressed_size) {
-                    layout.assign(buffer.begin(), buffer.end());
-                }
-                unzCloseCurrentFile(uf);
-            }
-        }
+    // Index every entry in a single pass over the central directory
+    char name[512];
+    for (int rc = unzGoToFirstFile(uf); rc == UNZ_OK; rc = unzGoToNextFile(uf)) {
+        unz_file_info info;
+        if (unzGetCurrentFileInfo(uf, &info, name, sizeof(name), nullptr, 0, nullptr, 0) != UNZ_OK) continue;
+        unz_file_pos pos;
+        if (unzGetFilePos(uf, &pos) != UNZ_OK) continue;
+        Entry e;
+        e.dirPos = pos.pos_in_zip_directory;
+        e.fileNum = pos.num_of_file;
+        e.size = info.uncompressed_size;
+        entries[name] = e;
     }
 
-    // Extract assets.txt
-    if (unzLocateFile(uf, "assets.txt", 0) == UNZ_OK) {
-        unz_file_info fileInfo;
-        if (unzGetCurrentFileInfo(uf, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK) {
-            if (unzOpenCurrentFile(uf) == UNZ_OK) {
-                std::vector<char> buffer(fileInfo.uncompressed_size);
-                int read = unzReadCurrentFile(uf, buffer.data(), fileInfo.uncompressed_size);
-                if (read == fileInfo.uncompressed_size) {
-                    assets.assign(buffer.begin(), buffer.end());
-                }
-                unzCloseCurrentFile(uf);
-            }
-        }
+    handle = uf;
+    return true;
+}
+
+void ZipReader::close() {
+    if (handle) {
+        unzClose(static_cast<unzFile>(handle));
+        handle = nullptr;
     }
+    entries.clear();
+}
+
+bool ZipReader::has(const std::string& name) const {
+    return entries.count(name) != 0;
+}
+
+size_t ZipReader::entrySize(const std::string& name) const {
+    auto it = entries.find(name);
+    return it != entries.end() ? it->second.size : 0;
+}
+
+std::vector<std::string> ZipReader::entryNames() const {
+    std::vector<std::string> names;
+    names.reserve(entries.size());
+    for (const auto& kv : entries) names.push_back(kv.first);
+    return names;
+}
+
+uint64_t ZipReader::dataOffset(const std::string& name) {
+    if (!handle) return 0;
+    auto it = entries.find(name);
+    if (it == entries.end()) return 0;
+
+    unzFile uf = static_cast<unzFile>(handle);
+    unz_file_pos pos;
+    pos.pos_in_zip_directory = it->second.dirPos;
+    pos.num_of_file = it->second.fileNum;
+    if (unzGoToFilePos(uf, &pos) != UNZ_OK) return 0;
+    // Opening the entry parses its local header, which is what locates the data
+    if (unzOpenCurrentFile(uf) != UNZ_OK) return 0;
+    uint64_t offset = unzGetCurrentFileZStreamPos64(uf);
+    unzCloseCurrentFile(uf);
+    return offset;
+}
+
+bool ZipReader::read(const std::string& name, char* dst, size_t capacity) {
+    if (!handle) return false;
+    auto it = entries.find(name);
+    if (it == entries.end() || capacity < it->second.size) return false;
+
+    unzFile uf = static_cast<unzFile>(handle);
+    unz_file_pos pos;
+    pos.pos_in_zip_directory = it->second.dirPos;
+    pos.num_of_file = it->second.fileNum;
+    if (unzGoToFilePos(uf, &pos) != UNZ_OK) return false;
+    if (unzOpenCurrentFile(uf) != UNZ_OK) return false;
+
+    size_t total = 0;
+    while (total < it->second.size) {
+        int n = unzReadCurrentFile(uf, dst + total, (unsigned)(it->second.size - total));
+        if (n <= 0) break;
+        total += (size_t)n;
+    }
+    unzCloseCurrentFile(uf);
+    return total == it->second.size;
+}
 
-    unzClose(uf);
-    return !layout.empty() && !assets.empty();
+bool ZipReader::read(const std::string& name, std::vector<char>& out) {
+    auto it = entries.find(name);
+    if (it == entries.end()) return false;
+    out.resize(it->second.size);
+    return read(name, out.data(), out.size());
 }
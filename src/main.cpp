@@ -4,15 +4,26 @@
 #include <SDL_mixer.h>
 #include <iostream>
 #include "Texture.h"
+#include "TextureCache.h"
+#include "SpriteAtlas.h"
+#include "SpriteBatch.h"
+#include "FontCache.h"
+#include "GlyphAtlas.h"
 #include "Player.h"
 #include "Level.h"
 #include "LevelEditor.h"
 #include "Menu.h"
 #include "MainMenu.h"
-#include "Enemy.h"
+#include "LevelPreloader.h"
+#include "LevelManifest.h"
+#include "LevelSaver.h"
+#include "EnemyPool.h"
 #include "Boss.h"
 #include "GameObjects.h"
 #include "Collision.h"
+#include "SpatialHash.h"
+#include "TileLayerCache.h"
+#include "Tiles.h"
 #include "SaveData.h"
 #include <algorithm>
 #include <cmath>
@@ -96,32 +107,80 @@ int main(int argc, char* argv[]) {
     Mix_VolumeMusic(64); // max volume for music
     Mix_Volume(-1, 128);  // max volume for chunks
 
-    TTF_Font* hudFont = nullptr;
-    std::string hudFontPath = (assetsDir + "BreeSerif-Regular.otf");
-    hudFont = TTF_OpenFont(hudFontPath.c_str(), 24); // larger for game over screens
-    if(!hudFont){
-        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "HUD font not opened: %s", TTF_GetError());
-        hudFont = nullptr;
-    }
+    // Fonts are opened once and shared by the HUD and the in-game menu
+    FontCache fonts;
+    const std::string uiFontPath = assetsDir + "BreeSerif-Regular.otf";
+    TTF_Font* hudFont = fonts.get(uiFontPath, 24); // larger for game over screens
+    // HUD strings are laid out from glyphs rasterized once
+    GlyphAtlas hudGlyphs(ren, hudFont);
 
     // Load save data
     SaveData saveData = loadProgress();
 
+    // Decoded backgrounds, shared by every level with the same image
+    TextureCache backgrounds;
+
+    // Writes saved levels on a worker thread so the editor keeps its frame rate
+    LevelSaver saver;
+    std::string saveNotice; // path whose completion is announced to the player
+
+    // Sprites and the height they are drawn at in logical pixels; the sources are several
+    // times larger, so each one is scaled to its size on this display
+    const std::vector<PreloadSprite> spriteFiles = {
+        { "chodzenie_1.png", 48 }, { "chodzenie_2.png", 48 }, { "chodzenie_3.png", 48 },
+        { "ochroniarz_1.png", 48 }, { "ochroniarz_2.png", 48 }, { "ochroniarz_3.png", 48 },
+        { "piwo_1.png", 32 }, { "piwo_2.png", 32 }, { "piwo_w_kuflu.png", 32 }, { "pollitroka_1.png", 32 },
+        { "piwo_w_butelce.png", 32 }, { "woda.png", 32 }, { "pollitrowka_3.png", 32 }, { "pollitrowka_2.png", 32 },
+        { "zelazo.png", 32 }, { "boss_1.png", 48 }, { "boss_2.png", 48 }, { "boss_3.png", 48 } };
+    auto outputScale = [&]() {
+        int outW = 0, outH = 0;
+        SDL_GetRendererOutputSize(ren, &outW, &outH);
+        return std::max(1.0f, std::min((float)outW / WINW, (float)outH / WINH));
+    };
+
+    // Decodes and scales sprites and loads levels on a worker thread while the menu is shown
+    LevelPreloader preloader(assetsDir, spriteFiles, outputScale());
+
+    // Level metadata cached in levels.manifest
+    LevelManifest manifest;
+
     // Main game loop
     while (true) {
         // Play menu music
         if (menuMusic) Mix_PlayMusic(menuMusic, -1);
 
-        // Calculate max level
-        int maxLevel = 1;
-        for(int i=1; i<32; i++) if(saveData.completedLevels & (1<<i)) maxLevel = std::min(9, i + 1);
-        if (saveData.hasKey) maxLevel = 10;
+        // Only archives changed since the manifest was written get opened here
+        manifest.refresh();
 
         // Show main menu
-        MainMenu mainMenu(ren, assetsDir, maxLevel);
+        MainMenu mainMenu(ren, assetsDir, manifest, saveData, &preloader);
         int selectedLevel = mainMenu.run();
         if (selectedLevel == -1) break; // kill
 
+        // Level data and decoded images prepared while the menu was up (nullptr if not requested)
+        std::unique_ptr<PreloadedLevel> pre = preloader.take(selectedLevel);
+        // Sprites go into one atlas as the preloader scaled them. A reload, or a display
+        // that changed since the preloader started, decodes and scales them here instead.
+        float displayScale = outputScale();
+        SpriteAtlas atlas;
+        bool spritesFromDisk = false; // set by the Reload textures menu entry
+        std::vector<SDL_Surface*> scaledHere; // freed once the atlas is built
+        auto loadSprite = [&](Texture& t, const char* file) {
+            SDL_Surface* surf = nullptr;
+            if (spritesFromDisk || displayScale != preloader.displayScale()) {
+                auto it = std::find_if(spriteFiles.begin(), spriteFiles.end(), [&](const PreloadSprite& sprite) { return sprite.file == file; });
+                int drawH = it != spriteFiles.end() ? it->drawH : 0;
+                if (SDL_Surface* decoded = Texture::decodeFile(assetsDir + file)) {
+                    surf = SpriteAtlas::scaleToHeight(decoded, (int)std::ceil(drawH * displayScale), file);
+                    SDL_FreeSurface(decoded);
+                    if (surf) scaledHere.push_back(surf);
+                }
+            }
+            // The preloaded image also covers a file that fails to load again
+            if (!surf) surf = preloader.sprite(file);
+            atlas.add(t, surf, file);
+        };
+
         if (selectedLevel == 10) {
             if (bossMusic) Mix_PlayMusic(bossMusic, -1);
         } else {
@@ -132,37 +191,45 @@ int main(int argc, char* argv[]) {
         if (selectedLevel == 10) bgFile = "boss_tlo.png";
 
         // Load assets using assetsDir
-        Texture bgTex;
-        bgTex.load(ren, (assetsDir + bgFile).c_str());
-
         Texture f1,f2,f3,f4,f5,f6;
-        f1.load(ren, (assetsDir + "chodzenie_1.png").c_str());
-        f2.load(ren, (assetsDir + "chodzenie_2.png").c_str());
-        f3.load(ren, (assetsDir + "chodzenie_3.png").c_str());
-        f4.load(ren, (assetsDir + "ochroniarz_1.png").c_str());
-        f5.load(ren, (assetsDir + "ochroniarz_2.png").c_str());
-        f6.load(ren, (assetsDir + "ochroniarz_3.png").c_str());
-
-        // Load pickup textures
         Texture piwo1, piwo2, piwoKufel, pollitroka, piwoButelka, woda, pollitrowka3, pollitrowka2, zelazo;
-        piwo1.load(ren, (assetsDir + "piwo_1.png").c_str());
-        piwo2.load(ren, (assetsDir + "piwo_2.png").c_str());
-        piwoKufel.load(ren, (assetsDir + "piwo_w_kuflu.png").c_str());
-        pollitroka.load(ren, (assetsDir + "pollitroka_1.png").c_str());
-        piwoButelka.load(ren, (assetsDir + "piwo_w_butelce.png").c_str());
-        woda.load(ren, (assetsDir + "woda.png").c_str());
-        pollitrowka3.load(ren, (assetsDir + "pollitrowka_3.png").c_str());
-        pollitrowka2.load(ren, (assetsDir + "pollitrowka_2.png").c_str());
-        zelazo.load(ren, (assetsDir + "zelazo.png").c_str());
-
-        // Load boss textures
         Texture boss1, boss2, boss3;
-        boss1.load(ren, (assetsDir + "boss_1.png").c_str());
-        boss2.load(ren, (assetsDir + "boss_2.png").c_str());
-        boss3.load(ren, (assetsDir + "boss_3.png").c_str());
+        auto loadSprites = [&]() {
+            atlas.clear();
+            loadSprite(f1, "chodzenie_1.png");
+            loadSprite(f2, "chodzenie_2.png");
+            loadSprite(f3, "chodzenie_3.png");
+            loadSprite(f4, "ochroniarz_1.png");
+            loadSprite(f5, "ochroniarz_2.png");
+            loadSprite(f6, "ochroniarz_3.png");
+
+            // Pickups, also used as tiles and projectiles
+            loadSprite(piwo1, "piwo_1.png");
+            loadSprite(piwo2, "piwo_2.png");
+            loadSprite(piwoKufel, "piwo_w_kuflu.png");
+            loadSprite(pollitroka, "pollitroka_1.png");
+            loadSprite(piwoButelka, "piwo_w_butelce.png");
+            loadSprite(woda, "woda.png");
+            loadSprite(pollitrowka3, "pollitrowka_3.png");
+            loadSprite(pollitrowka2, "pollitrowka_2.png");
+            loadSprite(zelazo, "zelazo.png");
+
+            loadSprite(boss1, "boss_1.png");
+            loadSprite(boss2, "boss_2.png");
+            loadSprite(boss3, "boss_3.png");
+            atlas.build(ren);
+            for (SDL_Surface* surf : scaledHere) SDL_FreeSurface(surf);
+            scaledHere.clear();
+        };
+        loadSprites();
+
+        // Tile sprites by Tiles::TextureId
+        const Texture* tileTextures[Tiles::TEX_COUNT] = {
+            nullptr, &woda, &piwo1, &piwo2, &piwoKufel, &pollitroka, &piwoButelka, &pollitrowka3, &pollitrowka2, &zelazo
+        };
 
         // Abort gracefully if required textures are missing
-        if (!bgTex.tex || !f1.tex || !f2.tex || !f3.tex) {
+        if (!f1.tex || !f2.tex || !f3.tex) {
             SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Missing assets",
                                      "One or more assets failed to load. Ensure the `assets` folder is next to the executable or adjust the working directory.",
                                      win);
@@ -181,20 +248,15 @@ int main(int argc, char* argv[]) {
         level.setFrameSize(WINW, WINH);
 
         // Ensure rows is initialized before allocating the grid (tile size = 32)
-        level.rows = WINH / 32 + 1;
-
-        level.cols = 156; // map size
-        if (selectedLevel == 10) level.cols = 16;
-        level.grid.assign(level.rows, std::vector<int>(level.cols, 0));
+        level.reset(WINH / 32 + 1, selectedLevel == 10 ? 16 : 156); // map size
         SDL_Log("DBG: level frame size set to %dx%d", WINW, WINH);
         int groundRow = level.rows - 2;
         if (groundRow >= 0) {
             for (int c = 0; c < level.cols; ++c) {
-                level.grid[groundRow][c] = 1; // solid ground
+                level.setTile(groundRow, c, 1); // solid ground
             }
         }
 
-        level.setBackgroundTexture(bgTex.tex);
         level.setBackgroundRepeat(false); // scroll once
         level.setScrollSpeed(0.0f); // no auto-scroll
         level.setParallax(0.25f); // parallax
@@ -210,14 +272,22 @@ int main(int argc, char* argv[]) {
         player.y = static_cast<float>(std::max<int>(0, levelH - player.height)); // put player on bottom of level
         player.onGround = true;
         player.vy = 0.0f;
+        player.prevX = player.x;
+        player.prevY = player.y;
 
         level.backgroundPath = bgFile;
         level.usedAssets = { assetsDir + "chodzenie_1.png", assetsDir + "chodzenie_2.png", assetsDir + "chodzenie_3.png", assetsDir + "ochroniarz_1.png", assetsDir + "ochroniarz_2.png", assetsDir + "ochroniarz_3.png", assetsDir + "piwo_1.png", assetsDir + "piwo_2.png", assetsDir + "piwo_w_kuflu.png", assetsDir + "pollitroka_1.png", assetsDir + "piwo_w_butelce.png", assetsDir + "woda.png", assetsDir + "pollitrowka_3.png", assetsDir + "pollitrowka_2.png", assetsDir + "zelazo.png" };
 
         // Declare game variables
-        std::vector<Enemy> enemies;
+        EnemyPool enemies;
         std::vector<Projectile> projectiles;
         std::vector<Blood> bloods;
+        SpatialHash contacts; // broadphase for the entity checks, rebuilt every step
+        Collision::EventQueue frameEvents; // what physics reported this frame
+        TileLayerCache tileLayer; // tiles pre-rendered in chunks, redrawn only when they change
+        SpriteBatch sprites; // characters, projectiles and blood, drawn once per texture
+        TextLabel scoreLabel, healthLabel, centerLabel, editorLabel, endLabel; // HUD text, relaid only on change
+        tileLayer.setTextures(tileTextures);
         Boss boss;
         bool playerLost = false;
         bool playerWon = false;
@@ -226,26 +296,66 @@ int main(int argc, char* argv[]) {
             boss.frames = {&boss1, &boss2, &boss3};
             boss.x = 8 * 32.0f;
             boss.y = (level.rows - 2) * 32.0f;
+            boss.prevX = boss.x;
+            boss.prevY = boss.y;
         }
 
         const float editorTileScale = 1.0f;   // used only by LevelEditor
         const float renderTileScale = 1.0f;   // used for runtime drawing / player size scaling
         const int baseTilePixels = 32;        // physical base tile size (used for collision/camera)
         float camX = 0.0f;
+        float camY = 0.0f;
         float editorCamX = 0.0f;
 
+        // Spawns an enemy at every spawn tile, syncing enemyPositions with the grid first
+        auto spawnEnemies = [&]() {
+            enemies.clear();
+            enemies.frames = { &f4, &f5, &f6 };
+            enemies.width = 32; enemies.height = 48;
+            level.markEnemySpawns();
+            level.collectEnemySpawns();
+            for (auto& p : level.enemyPositions) {
+                enemies.spawn(p.second * 32.0f, (p.first + 1) * 32.0f, 50.f); // on top of tile
+            }
+            enemies.sortByX();
+        };
+
         // Try to load level from file
         std::string levelFile = "level_" + std::to_string(selectedLevel) + ".zip";
         LevelEditor* editor = nullptr;
-        bool loaded = level.loadFromFile(levelFile);
+        bool loaded = false;
+        if (pre) {
+            loaded = pre->loaded;
+            if (loaded) level.takeLayout(pre->level);
+        } else {
+            loaded = level.loadFromFile(levelFile);
+        }
+
+        // Background: prefer the image embedded in the level zip, fall back to assets/
+        auto applyBackground = [&]() {
+            Texture* t = nullptr;
+            if (!level.backgroundData.empty()) {
+                t = backgrounds.fromMemory(ren, level.backgroundData.data(), level.backgroundData.size(), level.backgroundPath);
+            }
+            if (!t) t = backgrounds.fromFile(ren, assetsDir + level.backgroundPath);
+            if (t) level.setBackgroundTexture(t->tex);
+            return t != nullptr;
+        };
+        Texture* preloadedBg = nullptr;
+        if (loaded && pre && pre->background) {
+            preloadedBg = backgrounds.fromSurface(ren, pre->backgroundHash, pre->background, level.backgroundPath);
+        }
+        pre.reset();
+        if (preloadedBg) {
+            level.setBackgroundTexture(preloadedBg->tex);
+        } else if (!applyBackground()) {
+            SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Missing assets",
+                                     "The level background failed to load. Ensure the `assets` folder is next to the executable or adjust the working directory.",
+                                     win);
+            continue; // back to menu
+        }
+
         if (loaded) {
-            // Reload background texture
-            bgTex.load(ren, (assetsDir + level.backgroundPath).c_str());
-            level.setBackgroundTexture(bgTex.tex);
-            level.setBackgroundRepeat(false);
-            level.setScrollSpeed(0.0f);
-            level.setParallax(0.25f);
-            level.setBackgroundMaxSpeed(50.0f);
             // Recreate editor with new level size
             if (editor) delete editor;
             editor = new LevelEditor(&level, WINW, WINH, editorTileScale, baseTilePixels);
@@ -255,81 +365,36 @@ int main(int argc, char* argv[]) {
             player.y = static_cast<float>(std::max(0, levelH - player.height));
             player.onGround = true;
             player.vy = 0.0f;
+            player.prevX = player.x;
+            player.prevY = player.y;
             // Reset camera
             camX = 0.0f;
+            camY = 0.0f;
             editorCamX = 0.0f;
             // Repopulate enemies from the loaded grid
-            enemies.clear();
-            for (auto& p : level.enemyPositions) {
-                if (p.first >= 0 && p.first < level.rows && p.second >= 0 && p.second < level.cols) {
-                    level.grid[p.first][p.second] = 5;
-                }
-            }
-            for (int r = 0; r < level.rows; ++r) {
-                for (int c = 0; c < level.cols; ++c) {
-                    if (level.grid[r][c] == 5) {
-                        Enemy e;
-                        e.frames = { &f4, &f5, &f6 };
-                        e.width = 32; e.height = 48;
-                        e.x = (float)c * 32.0f;
-                        e.y = ((float)r + 1) * 32.0f;
-                        e.vx = 50.f;
-                        e.vy = 0.f;
-                        e.onGround = true;
-                        e.active = true;
-                        enemies.push_back(e);
-                    }
-                }
-            }
+            spawnEnemies();
         }
 
         if (!loaded) {
-            for (int r = 0; r < level.rows; ++r) {
-                for (int c = 0; c < level.cols; ++c) {
-                    if (level.grid[r][c] == 5) {
-                        Enemy e;
-                        e.frames = { &f4, &f5, &f6 };
-                        e.width = 32; e.height = 48;
-                        e.x = (float)c * 32.0f;
-                        e.y = ((float)r + 1) * 32.0f; // on top of tile
-                        e.vx = 50.f;
-                        e.vy = 0.f;
-                        e.onGround = true;
-                        e.active = true;
-                        enemies.push_back(e);
-                    }
-                }
-            }
+            spawnEnemies();
             // create editor
             editor = new LevelEditor(&level, WINW, WINH, editorTileScale, baseTilePixels);
         }
 
 
         // Menu setup
-        Menu menu(ren, (assetsDir + "BreeSerif-Regular.otf").c_str(), 18);
+        Menu menu(ren, fonts.get(uiFontPath, 18));
         menu.addItem("Reload textures", [&](){
-            f1.load(ren, (assetsDir + "chodzenie_1.png").c_str());
-            f2.load(ren, (assetsDir + "chodzenie_2.png").c_str());
-            f3.load(ren, (assetsDir + "chodzenie_3.png").c_str());
-            f4.load(ren, (assetsDir + "ochroniarz_1.png").c_str());
-            f5.load(ren, (assetsDir + "ochroniarz_2.png").c_str());
-            f6.load(ren, (assetsDir + "ochroniarz_3.png").c_str());
-            piwo1.load(ren, (assetsDir + "piwo_1.png").c_str());
-            piwo2.load(ren, (assetsDir + "piwo_2.png").c_str());
-            piwoKufel.load(ren, (assetsDir + "piwo_w_kuflu.png").c_str());
-            pollitroka.load(ren, (assetsDir + "pollitroka_1.png").c_str());
-            piwoButelka.load(ren, (assetsDir + "piwo_w_butelce.png").c_str());
-            woda.load(ren, (assetsDir + "woda.png").c_str());
-            pollitrowka3.load(ren, (assetsDir + "pollitrowka_3.png").c_str());
-            pollitrowka2.load(ren, (assetsDir + "pollitrowka_2.png").c_str());
-            zelazo.load(ren, (assetsDir + "zelazo.png").c_str());
-            boss1.load(ren, (assetsDir + "boss_1.png").c_str());
-            boss2.load(ren, (assetsDir + "boss_2.png").c_str());
-            boss3.load(ren, (assetsDir + "boss_3.png").c_str());
-
-            // Reload background texture
-            bgTex.load(ren, (assetsDir + level.backgroundPath).c_str());
-            level.setBackgroundTexture(bgTex.tex);
+            // Rebuilt through the atlas so the sprites stay on shared pages
+            spritesFromDisk = true;
+            loadSprites();
+            spritesFromDisk = false;
+            tileLayer.setTextures(tileTextures); // cached chunks still show the old sprites
+
+            // Reload background texture from disk (new content gets a new cache entry)
+            if (Texture* t = backgrounds.fromFile(ren, assetsDir + level.backgroundPath)) {
+                level.setBackgroundTexture(t->tex);
+            }
             level.setBackgroundRepeat(false);
             level.setScrollSpeed(0.0f);
             level.setParallax(0.25f);
@@ -337,33 +402,19 @@ int main(int argc, char* argv[]) {
             SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Menu", "Textures reloaded", win);
     });
         menu.addItem("Save level", [&](){
-            level.enemyPositions.clear();
-            for (int r = 0; r < level.rows; ++r) {
-                for (int c = 0; c < level.cols; ++c) {
-                    if (level.grid[r][c] == 5) {
-                        level.enemyPositions.push_back({r, c});
-                    }
-                }
-            }
-            level.saveToZip("level_" + std::to_string(selectedLevel) + ".zip", assetsDir);
-            SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Menu", "Level saved", win);
+            level.collectEnemySpawns();
+            saveNotice = "level_" + std::to_string(selectedLevel) + ".zip";
+            saver.save(level, saveNotice, assetsDir);
         });
 
         menu.addItem("Load level", [&](){
-            // Backup current level state
-            int oldRows = level.rows;
-            int oldCols = level.cols;
-            std::vector<std::vector<int>> oldGrid = level.grid;
-            std::vector<std::pair<int, int>> oldEnemyPositions = level.enemyPositions;
-            std::string oldBackgroundPath = level.backgroundPath;
-
             // Try to load level from file
             std::string levelFile = "level_" + std::to_string(selectedLevel) + ".zip";
+            saver.finish(level); // don't read an archive that is still being written
             bool loaded = level.loadFromFile(levelFile);
             if (loaded) {
                 // Reload background texture
-                bgTex.load(ren, (assetsDir + level.backgroundPath).c_str());
-                level.setBackgroundTexture(bgTex.tex);
+                applyBackground();
                 level.setBackgroundRepeat(false);
                 level.setScrollSpeed(0.0f);
                 level.setParallax(0.25f);
@@ -377,49 +428,26 @@ int main(int argc, char* argv[]) {
                 player.y = static_cast<float>(std::max(0, levelH - player.height));
                 player.onGround = true;
                 player.vy = 0.0f;
+                player.prevX = player.x;
+                player.prevY = player.y;
                 // Reset camera
                 camX = 0.0f;
+                camY = 0.0f;
                 editorCamX = 0.0f;
                 // Repopulate enemies from the loaded grid
-                enemies.clear();
-                for (auto& p : level.enemyPositions) {
-                    if (p.first >= 0 && p.first < level.rows && p.second >= 0 && p.second < level.cols) {
-                        level.grid[p.first][p.second] = 5;
-                    }
-                }
-                for (int r = 0; r < level.rows; ++r) {
-                    for (int c = 0; c < level.cols; ++c) {
-                        if (level.grid[r][c] == 5) {
-                            Enemy e;
-                            e.frames = { &f4, &f5, &f6 };
-                            e.width = 32; e.height = 48;
-                            e.x = (float)c * 32.0f;
-                            e.y = ((float)r + 1) * 32.0f;
-                            e.vx = 50.f;
-                            e.vy = 0.f;
-                            e.onGround = true;
-                            e.active = true;
-                            enemies.push_back(e);
-                        }
-                    }
-                }
+                spawnEnemies();
                 SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Menu", "Level loaded", win);
             } else {
-                // Restore level state on failure
-                level.rows = oldRows;
-                level.cols = oldCols;
-                level.grid = oldGrid;
-                level.enemyPositions = oldEnemyPositions;
-                level.backgroundPath = oldBackgroundPath;
+                // loadFromFile leaves the current level untouched on failure
                 SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Menu", "Failed to load level", win);
             }
         });
 
         menu.addItem("Reload level", [&](){
+            saver.finish(level);
             if (level.loadFromFile("level_saved.zip")) {
                 // Reload background texture
-                bgTex.load(ren, (assetsDir + level.backgroundPath).c_str());
-                level.setBackgroundTexture(bgTex.tex);
+                applyBackground();
                 level.setBackgroundRepeat(false);
                 level.setScrollSpeed(0.0f);
                 level.setParallax(0.25f);
@@ -433,33 +461,14 @@ int main(int argc, char* argv[]) {
                 player.y = static_cast<float>(std::max(0, levelH - player.height));
                 player.onGround = true;
                 player.vy = 0.0f;
+                player.prevX = player.x;
+                player.prevY = player.y;
                 // Reset camera
                 camX = 0.0f;
+                camY = 0.0f;
                 editorCamX = 0.0f;
                 // Repopulate enemies from loaded grid
-                enemies.clear();
-                for (auto& p : level.enemyPositions) {
-                    if (p.first >= 0 && p.first < level.rows && p.second >= 0 && p.second < level.cols) {
-                        level.grid[p.first][p.second] = 5;
-                    }
-                }
-                for (int r = 0; r < level.rows; ++r) {
-                    for (int c = 0; c < level.cols; ++c) {
-                        if (level.grid[r][c] == 5) {
-                            Enemy e;
-                            e.frames = { &f4, &f5, &f6 };
-                            e.width = 32; e.height = 48;
-                            e.x = (float)c * 32.0f;
-                            e.y = ((float)r + 1) * 32.0f;
-                            e.vx = 50.f;
-                            e.vy = 0.f;
-                            e.onGround = true;
-                            e.active = true;
-                            enemies.push_back(e);
-                            // level.grid[r][c] = 0;
-                        }
-                    }
-                }
+                spawnEnemies();
                 SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Menu", "Level reloaded", win);
             } else {
                 SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Menu", "Failed to reload level", win);
@@ -471,6 +480,25 @@ int main(int argc, char* argv[]) {
         float fade = 0.0f;
         Uint64 last = SDL_GetPerformanceCounter();
 
+        // Fixed simulation step; a frame runs at most MAX_SIM_STEPS of them
+        const double SIM_DT = 1.0 / 120.0;
+        const int MAX_SIM_STEPS = 8;
+        double simAccumulator = 0.0;
+        // Guards further than this past the edges of the view sleep until the view comes back
+        const float ACTIVE_MARGIN = 256.0f;
+
+        // Index range of the guards near the view. The view follows the player, so it is
+        // worked out from the simulated player, not the interpolated camera, which keeps
+        // what sleeps and wakes the same whatever the frame rate.
+        auto activeGuards = [&]() {
+            float viewW = (float)WINW / renderTileScale;
+            float levelWidth = (float)(level.cols * baseTilePixels);
+            float viewLeft = player.x + player.width * 0.5f - viewW * 0.5f;
+            viewLeft = std::max(0.0f, std::min(viewLeft, std::max(0.0f, levelWidth - viewW)));
+            return std::make_pair(enemies.lowerBound(viewLeft - ACTIVE_MARGIN - enemies.width),
+                                  enemies.upperBound(viewLeft + viewW + ACTIVE_MARGIN));
+        };
+
         // Game loop
         while(running) {
             const Uint8* kb = SDL_GetKeyboardState(nullptr);
@@ -498,6 +526,12 @@ int main(int argc, char* argv[]) {
             while (SDL_PollEvent(&ev)) {
                 if (ev.type == SDL_QUIT) { running = false; break; }
 
+                if (ev.type == SDL_RENDER_TARGETS_RESET || ev.type == SDL_RENDER_DEVICE_RESET) {
+                    // The cached tile chunks lost their contents
+                    tileLayer.clear();
+                    continue;
+                }
+
                 if (ev.type == SDL_WINDOWEVENT && ev.window.event == SDL_WINDOWEVENT_RESIZED) {
                     // Recreate editor on window size change
                     delete editor;
@@ -521,40 +555,15 @@ int main(int argc, char* argv[]) {
                         if (editMode) {
                             editorCamX = camX;
                             // Show enemy spawns in grid
-                            for (auto& p : level.enemyPositions) {
-                                if (p.first >= 0 && p.first < level.rows && p.second >= 0 && p.second < level.cols) {
-                                    level.grid[p.first][p.second] = 5;
-                                }
-                            }
+                            level.markEnemySpawns();
                         } else {
-                            // Update enemyPositions from grid
-                            level.enemyPositions.clear();
-                            for (int r = 0; r < level.rows; ++r) {
-                                for (int c = 0; c < level.cols; ++c) {
-                                    if (level.grid[r][c] == 5) {
-                                        level.enemyPositions.push_back({r, c});
-                                    }
-                                }
-                            }
-                            // Repopulate enemies from grid
-                            enemies.clear();
-                            for (auto& p : level.enemyPositions) {
-                                Enemy e;
-                                e.frames = { &f4, &f5, &f6 };
-                                e.width = 32; e.height = 48;
-                                e.x = p.second * 32.0f;
-                                e.y = (p.first + 1) * 32.0f;
-                                e.vx = 50.f;
-                                e.vy = 0.f;
-                                e.onGround = true;
-                                enemies.push_back(e);
-                                level.grid[p.first][p.second] = 5; // remember
-                            }
+                            // Update enemyPositions from grid and repopulate enemies
+                            spawnEnemies();
                         }
                         continue;
                     }
                     if (ev.key.keysym.scancode == SDL_SCANCODE_S && (SDL_GetModState() & KMOD_CTRL)) {
-                        level.saveToZip("level_saved.zip", assetsDir);
+                        saver.save(level, "level_saved.zip", assetsDir);
                         continue;
                     }
                     if (ev.key.keysym.scancode == SDL_SCANCODE_F11) {
@@ -606,47 +615,34 @@ int main(int argc, char* argv[]) {
 
                     // Compute floating camera offset in editor pixel-space (avoid rounding)
                     float camX_editor_f = camX * editorScale;
+                    float camY_editor_f = camY * editorScale;
 
                     // Pass float logical coordinates to editor for precise mapping
-                    editor->handleMouse(mx_editor, my_editor, camX_editor_f);
+                    editor->handleMouse(mx_editor, my_editor, camX_editor_f, camY_editor_f);
                     continue;
                 }
                 } // frame update & render
+                // Report saves the writer finished since the last frame
+                for (const auto& saved : saver.poll(level)) {
+                    if (!saved.ok) {
+                        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Menu", "Failed to save level", win);
+                    } else if (saved.path == saveNotice) {
+                        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Menu", "Level saved", win);
+                    }
+                    if (saved.path == saveNotice) saveNotice.clear();
+                }
+                // Large levels keep only the chunks around the view resident; in play the view
+                // follows the player, so stream around them before this frame's physics
+                float streamX = editMode ? editorCamX : player.x - WINW * 0.5f;
+                float streamY = editMode ? camY : player.y - WINH * 0.5f;
+                level.streamAround(streamX, streamY, WINW, WINH, baseTilePixels);
                 int levelW = level.cols * baseTilePixels;
                 int physCellW = baseTilePixels;
                 int physCellH = baseTilePixels;
-                if (!editMode && !playerLost && !playerWon) player.update(dt, kb);
                 if (!editMode && player.onGround && fabs(player.vx) > 0.1f && stepCooldown <= 0.0f) {
                     if (globalStepSound) Mix_PlayChannel(-1, globalStepSound, 0);
                     stepCooldown = 0.75f;
                 }
-                if ((kb[SDL_SCANCODE_DOWN] || kb[SDL_SCANCODE_S] ) && player.projectileCooldown <= 0 && !editMode && !playerLost && !playerWon) {
-                    Projectile p;
-                    p.tex = &piwo1;
-                    p.width = 16; p.height = 16;
-                    p.x = player.x + player.width / 2.0f - p.width / 2.0f;
-                    p.y = player.y - player.height / 2.0f - p.height / 2.0f;
-                    p.vx = player.facingLeft ? -250 : 250;
-                    p.vy = -400;
-                    p.active = true;
-                    p.fromPlayer = true;
-                    projectiles.push_back(p);
-                    player.projectileCooldown = 0.5f;
-                }
-                if (!editMode && !playerLost && !playerWon) {
-                    for (auto& e : enemies) {
-                        e.update(dt, levelW);
-                    }
-                    for (auto& e : enemies) {
-                        Collision::resolveEnemyCollisions(e, level, physCellW, physCellH);
-                    }
-                }
-
-                if (!editMode && !playerLost && !playerWon && selectedLevel == 10) {
-                    boss.update((float)dt, player, projectiles, zelazo, levelW);
-                    Collision::resolveBossCollisions(boss, level, physCellW, physCellH);
-                }
-
                 if (editMode) {
                     if (kb[SDL_SCANCODE_LEFT]) editorCamX -= 2000.0f * dt;
                     if (kb[SDL_SCANCODE_RIGHT]) editorCamX += 2000.0f * dt;
@@ -654,82 +650,300 @@ int main(int argc, char* argv[]) {
                     editorCamX = std::max(0.0f, std::min(editorCamX, maxCam));
                 }
 
-                // Update projectiles
+                // Physics runs in fixed SIM_DT steps however long the frame took, so jump heights
+                // and collisions don't depend on the frame rate. Rendering blends the last two steps.
                 int levelH_now = level.rows * physCellH;
-                for (auto& p : projectiles) {
-                    if (p.hasPhysics) {
-                        p.vy += 1200.f * dt;
-                    } else {
-                        p.lifetime -= dt;
-                        if (p.lifetime <= 0) p.active = false;
+                simAccumulator += dt;
+                int simSteps = 0;
+                while (running && simAccumulator >= SIM_DT && simSteps < MAX_SIM_STEPS) {
+                    const double simDt = SIM_DT;
+                    simAccumulator -= SIM_DT;
+                    ++simSteps;
+
+                    // Remember where everything was so rendering can blend towards this step
+                    player.prevX = player.x; player.prevY = player.y;
+                    std::pair<size_t, size_t> active = activeGuards();
+                    enemies.savePrevious(active.first, active.second);
+                    for (auto& p : projectiles) { p.prevX = p.x; p.prevY = p.y; }
+                    boss.prevX = boss.x; boss.prevY = boss.y;
+
+                    if (!editMode && !playerLost && !playerWon) player.update(simDt, kb);
+                    if ((kb[SDL_SCANCODE_DOWN] || kb[SDL_SCANCODE_S] ) && player.projectileCooldown <= 0 && !editMode && !playerLost && !playerWon) {
+                        Projectile p;
+                        p.tex = &piwo1;
+                        p.width = 16; p.height = 16;
+                        p.x = player.x + player.width / 2.0f - p.width / 2.0f;
+                        p.y = player.y - player.height / 2.0f - p.height / 2.0f;
+                        p.prevX = p.x;
+                        p.prevY = p.y;
+                        p.vx = player.facingLeft ? -250 : 250;
+                        p.vy = -400;
+                        p.active = true;
+                        p.fromPlayer = true;
+                        projectiles.push_back(p);
+                        player.projectileCooldown = 0.5f;
+                    }
+                    if (!editMode && !playerLost && !playerWon) {
+                        // Only guards near the view run; of those, ones far above or below it and
+                        // ones outside the resident chunks wait too
+                        float viewH = (float)WINH / renderTileScale;
+                        float bandTop = player.y - player.height * 0.5f - viewH * 0.5f - ACTIVE_MARGIN;
+                        float bandBottom = bandTop + viewH + 2.0f * ACTIVE_MARGIN + enemies.height;
+                        for (size_t i = active.first; i < active.second; ++i) {
+                            float ey = enemies.y[i];
+                            enemies.awake[i] = ey >= bandTop && ey <= bandBottom &&
+                                               (!level.isStreamed() ||
+                                                level.isResident((int)std::floor((ey - 1.0f) / physCellH), (int)std::floor(enemies.x[i] / physCellW)));
+                        }
+                        enemies.update(simDt, levelW, active.first, active.second);
+                        for (size_t i = active.first; i < active.second; ++i) {
+                            if (!enemies.awake[i]) continue;
+                            Enemy e = enemies.body(i);
+                            Collision::resolveEnemyCollisions(e, level, physCellW, physCellH);
+                            enemies.setBody(i, e);
+                        }
+                        enemies.restoreOrder(active.first, active.second);
+                    }
+
+                    if (!editMode && !playerLost && !playerWon && selectedLevel == 10) {
+                        boss.update((float)simDt, player, projectiles, zelazo, levelW);
+                        Collision::resolveBossCollisions(boss, level, physCellW, physCellH);
+                    }
+
+                    // Update projectiles
+                    for (auto& p : projectiles) {
+                        if (p.hasPhysics) {
+                            p.vy += 1200.f * simDt;
+                        } else {
+                            p.lifetime -= simDt;
+                            if (p.lifetime <= 0) p.active = false;
+                        }
+                        float stepX = (float)(p.vx * simDt);
+                        float stepY = (float)(p.vy * simDt);
+                        if (p.active && p.hasPhysics) {
+                            // Most shots fly through open air; the solid bits rule that out a row at a
+                            // time before any tile is swept
+                            int c0 = (int)std::floor(std::min(p.x, p.x + stepX) / physCellW);
+                            int c1 = (int)std::floor((std::max(p.x, p.x + stepX) + p.width - 0.001f) / physCellW);
+                            int r0 = (int)std::floor(std::min(p.y, p.y + stepY) / physCellH);
+                            int r1 = (int)std::floor((std::max(p.y, p.y + stepY) + p.height - 0.001f) / physCellH);
+                            bool nearWall = false;
+                            for (int r = r0; r <= r1 && !nearWall; ++r) nearWall = level.anySolidInSpan(r, c0, c1);
+                            // Stop at the first wall on the way so fast shots can't pass through it
+                            Collision::SweepHit hit;
+                            if (nearWall) hit = Collision::sweepTiles(level, p.x, p.y, (float)p.width, (float)p.height,
+                                                                      stepX, stepY, physCellW, physCellH, Tiles::F_SOLID);
+                            if (hit.hit) {
+                                stepX *= hit.t;
+                                stepY *= hit.t;
+                                p.active = false;
+                            }
+                        }
+                        p.x += stepX;
+                        p.y += stepY;
+                        if (p.x < -100 || p.x > levelW + 100 || p.y < -100 || p.y > levelH_now + 100) p.active = false;
+                    }
+                    // Remove inactive enemies
+                    enemies.removeInactive();
+                    active = activeGuards();
+
+                    // Hash everything the player and the shots can touch; projectiles cover their whole
+                    // path this step. The player is only ever the query side, so it is not inserted.
+                    // Only guards in the active range go in; ones in it that sleep (far above or
+                    // below, or not resident) are still hashed, they just don't move.
+                    contacts.clear();
+                    for (size_t i = active.first; i < active.second; ++i) {
+                        contacts.insert(SpatialHash::ENEMY, (int)i, enemies.x[i], enemies.y[i] - enemies.height, (float)enemies.width, (float)enemies.height);
                     }
-                    p.x += p.vx * dt;
-                    p.y += p.vy * dt;
-                    if (p.x < -100 || p.x > levelW + 100 || p.y < -100 || p.y > levelH_now + 100) p.active = false;
-                    if (p.active && p.hasPhysics) {
-                        int col = (int)(p.x / physCellW);
-                        int row = (int)(p.y / physCellH);
-                        if (row >= 0 && row < level.rows && col >= 0 && col < level.cols && level.grid[row][col] == 1) {
+                    if (selectedLevel == 10) contacts.insert(SpatialHash::BOSS, 0, boss.x, boss.y - boss.height, (float)boss.width, (float)boss.height);
+                    for (size_t i = 0; i < projectiles.size(); ++i) {
+                        const Projectile& p = projectiles[i];
+                        if (!p.active) continue;
+                        float left = std::min(p.prevX, p.x), top = std::min(p.prevY, p.y);
+                        contacts.insert(SpatialHash::PROJECTILE, (int)i, left, top,
+                                        std::fabs(p.x - p.prevX) + p.width, std::fabs(p.y - p.prevY) + p.height);
+                    }
+                    auto projectileHits = [](const Projectile& p, float left, float top, float w, float h) {
+                        return Collision::sweptOverlap(p.prevX, p.prevY, p.x, p.y, (float)p.width, (float)p.height, left, top, w, h);
+                    };
+
+                    // Player projectiles against enemies and the boss
+                    for (auto& p : projectiles) {
+                        if (!p.active || !p.fromPlayer) continue;
+                        // The first enemy in the list that the shot touches takes it
+                        int hitEnemy = -1;
+                        bool hitBoss = false;
+                        contacts.query(std::min(p.prevX, p.x), std::min(p.prevY, p.y),
+                                       std::fabs(p.x - p.prevX) + p.width, std::fabs(p.y - p.prevY) + p.height,
+                                       SpatialHash::ENEMY | SpatialHash::BOSS, [&](SpatialHash::Kind kind, int i) {
+                            if (kind == SpatialHash::BOSS) {
+                                hitBoss = projectileHits(p, boss.x, boss.y - boss.height, (float)boss.width, (float)boss.height);
+                                return;
+                            }
+                            if (hitEnemy >= 0 && i > hitEnemy) return;
+                            if (projectileHits(p, enemies.x[i], enemies.y[i] - enemies.height, (float)enemies.width, (float)enemies.height)) hitEnemy = i;
+                        });
+                        if (hitEnemy >= 0) {
+                            enemies.kill(hitEnemy);
+                            Collision::Event killed{ Collision::Event::ENEMY_KILLED };
+                            killed.x = enemies.x[hitEnemy];
+                            killed.y = enemies.y[hitEnemy] - enemies.height / 2.0f;
+                            killed.w = enemies.width;
+                            frameEvents.push(killed);
+                            p.active = false;
+                        } else if (hitBoss) {
+                            boss.hp -= 1;
                             p.active = false;
                         }
                     }
-                }
-                // Check projectile collision with player
-                for (auto& p : projectiles) {
-                    if (p.active) {
-                        if (p.fromPlayer) {
-                            // check with enemies
-                            for (auto& e : enemies) {
-                                if (p.x < e.x + e.width && p.x + p.width > e.x && p.y < e.y && p.y + p.height > e.y - e.height) {
-                                    e.isDead = true;
-                                    e.curFrame = 0;
-                                    e.frameTime = 0;
-                                    // Add blood particles
-                                    for (int i = 0; i < 5; ++i) {
-                                        Blood b;
-                                        b.x = e.x + (rand() % e.width);
-                                        b.y = e.y - e.height / 2.0f;
-                                        b.vx = (rand() % 200) - 100;
-                                        b.vy = -(rand() % 200);
-                                        b.lifetime = 60;
-                                        bloods.push_back(b);
+                    // Enemy projectiles against the player, found from the player's cells
+                    contacts.query(player.x, player.y - player.height, (float)player.width, (float)player.height,
+                                   SpatialHash::PROJECTILE, [&](SpatialHash::Kind, int i) {
+                        Projectile& p = projectiles[i];
+                        if (!p.active || p.fromPlayer) return;
+                        if (!projectileHits(p, player.x, player.y - player.height, (float)player.width, (float)player.height)) return;
+                        if (player.invulnTimer <= 0.0f) {
+                            player.health -= 1;
+                            player.invulnTimer = player.invuln;
+                            if (player.health < 0) player.health = 0;
+                            frameEvents.push({ Collision::Event::DAMAGE });
+                        }
+                        p.active = false;
+                    });
+                    // Remove inactive projectiles
+                    projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(), [](const Projectile& p){ return !p.active; }), projectiles.end());
+
+                    // Update bloods
+                    for (auto& b : bloods) {
+                        b.vy += 1200.f * simDt;
+                        b.x += b.vx * simDt;
+                        b.y += b.vy * simDt;
+                        b.lifetime--;
+                    }
+                    bloods.erase(std::remove_if(bloods.begin(), bloods.end(), [](const Blood& b){ return b.lifetime <= 0; }), bloods.end());
+
+                    if (!editMode && !playerLost && !playerWon) {
+                        Collision::resolvePlayerCollisions(player, level, physCellW , physCellH, frameEvents);
+                        // Walking off a ledge leaves nothing under the feet: the player stays on the
+                        // ground only while some column below them has its first solid tile right there
+                        if (player.onGround) {
+                            int feetRow = (int)std::floor((player.y + 1.0f) / physCellH);
+                            int c0 = (int)std::floor(player.x / physCellW);
+                            int c1 = (int)std::floor((player.x + player.width - 0.001f) / physCellW);
+                            bool grounded = false;
+                            for (int c = c0; c <= c1 && !grounded; ++c) grounded = level.firstSolidBelow(feetRow, c) == feetRow;
+                            if (!grounded) player.onGround = false;
+                        }
+
+                        // Check collision with enemies and the boss; the player may have been pushed
+                        // since the hash was built but enemies and the boss have not moved
+                        float px = player.x;
+                        float pw = player.width;
+                        float pt = player.y - player.height;
+                        float ph = player.height;
+                        contacts.query(px, pt, pw, ph, SpatialHash::ENEMY | SpatialHash::BOSS, [&](SpatialHash::Kind kind, int i) {
+                            if (kind == SpatialHash::BOSS) {
+                                float bx = boss.x;
+                                float bw = boss.width;
+                                float bt = boss.y - boss.height;
+                                float bh = boss.height;
+                                if (px < bx + bw && px + pw > bx && pt < bt + bh && pt + ph > bt) {
+                                    if (boss.invulnTimer <= 0.0f) {
+                                        boss.hp -= 1;
+                                        boss.invulnTimer = boss.invuln;
                                     }
-                                    p.active = false;
-                                    break;
-                                }
-                            }
-                            if (p.active && selectedLevel == 10) {
-                                if (p.x < boss.x + boss.width && p.x + p.width > boss.x && p.y < boss.y && p.y + p.height > boss.y - boss.height) {
-                                    boss.hp -= 1;
-                                    p.active = false;
                                 }
+                                return;
                             }
-                        } else {
-                            // check with player
-                            if (p.x < player.x + player.width && p.x + p.width > player.x && p.y < player.y && p.y + p.height > player.y - player.height) {
+                            float ex = enemies.x[i];
+                            float ew = enemies.width;
+                            float et = enemies.y[i];
+                            float eh = enemies.height;
+                            if (px < ex + ew && px + pw > ex && pt < et && pt + ph > et - eh) {
                                 if (player.invulnTimer <= 0.0f) {
                                     player.health -= 1;
                                     player.invulnTimer = player.invuln;
                                     if (player.health < 0) player.health = 0;
+                                    frameEvents.push({ Collision::Event::DAMAGE });
                                 }
-                                p.active = false;
                             }
+                        });
+
+                        // Check for game over conditions
+                        if (player.health <= 0) {
+                            playerLost = true;
+                            fade = 0.0f;
+                            running = false;
+                            if (globalDeadSound) Mix_PlayChannel(-1, globalDeadSound, 0);
+                        }
+                        if (player.x >= levelW - player.width && selectedLevel != 10) {
+                            playerWon = true;
+                            running = false;
+                        }
+                        if (selectedLevel == 10 && boss.hp <= 0) {
+                            playerWon = true;
+                            running = false;
                         }
                     }
-                }
-                // Remove inactive projectiles
-                projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(), [](const Projectile& p){ return !p.active; }), projectiles.end());
-                // Remove inactive enemies
-                enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const Enemy& e){ return !e.active; }), enemies.end());
 
-                // Update bloods
-                for (auto& b : bloods) {
-                    b.vy += 1200.f * dt;
-                    b.x += b.vx * dt;
-                    b.y += b.vy * dt;
-                    b.lifetime--;
+                    // clamp player to level bounds (physics units)
+                    if (levelW > 0) {
+                        if (player.x < 0.f) player.x = 0.f;
+                        float maxPlayerX = (float)std::max(0, levelW - player.width);
+                        if (player.x > maxPlayerX) player.x = maxPlayerX;
+                    }
+                    if (levelH_now > 0) {
+                        if (player.y > levelH_now - player.height) {
+                            player.health = 0;
+                        } else {
+                            if (player.y < 0.f) player.y = 0.f;
+                            float maxPlayerY = (float)std::max(0, levelH_now - player.height);
+                            if (player.y > maxPlayerY) { player.y = maxPlayerY; player.onGround = true; player.vy = 0.f; }
+                        }
+                    }
                 }
-                bloods.erase(std::remove_if(bloods.begin(), bloods.end(), [](const Blood& b){ return b.lifetime <= 0; }), bloods.end());
+                // After a long hitch drop the time that is left instead of catching up forever
+                if (simSteps == MAX_SIM_STEPS) simAccumulator = std::min(simAccumulator, SIM_DT);
+
+                // Handle what physics reported, once per frame: one pickup sound however many
+                // pickups were taken, and at most one save
+                {
+                    bool picked = false;
+                    bool keyCollected = false;
+                    for (const Collision::Event& ev : frameEvents) {
+                        switch (ev.type) {
+                        case Collision::Event::PICKUP:
+                            player.score += ev.points;
+                            picked = true;
+                            break;
+                        case Collision::Event::KEY:
+                            keyCollected = true;
+                            break;
+                        case Collision::Event::ENEMY_KILLED:
+                            for (int i = 0; i < 5; ++i) {
+                                Blood b;
+                                b.x = ev.x + (rand() % ev.w);
+                                b.y = ev.y;
+                                b.vx = (rand() % 200) - 100;
+                                b.vy = -(rand() % 200);
+                                b.lifetime = 120; // steps
+                                bloods.push_back(b);
+                            }
+                            break;
+                        case Collision::Event::DAMAGE:
+                            break; // health was taken off where it happened
+                        }
+                    }
+                    if (picked && globalPickSound) Mix_PlayChannel(-1, globalPickSound, 0);
+                    if (keyCollected) {
+                        saveData.hasKey = true;
+                        saveProgress(saveData);
+                    }
+                    frameEvents.clear();
+                }
+                float alpha = static_cast<float>(simAccumulator / SIM_DT);
+                float playerDrawX = player.prevX + (player.x - player.prevX) * alpha;
+                float playerDrawY = player.prevY + (player.y - player.prevY) * alpha;
 
                 // Use logical size for drawing / camera math
                 int winW = WINW;
@@ -743,81 +957,8 @@ int main(int argc, char* argv[]) {
                 int worldW = std::max(levelW, winW);
                 int worldH = std::max(levelH_now, winH);
 
-                if (!editMode && !playerLost && !playerWon) {
-                    Collision::resolvePlayerCollisions(player, level, physCellW , physCellH, saveData);
-
-                    // Check collision with enemy
-                    for (auto& enemy : enemies) {
-                        float ex = enemy.x;
-                        float ew = enemy.width;
-                        float et = enemy.y;
-                        float eh = enemy.height;
-                        float px = player.x;
-                        float pw = player.width;
-                        float pt = player.y - player.height;
-                        float ph = player.height;
-                        if (px < ex + ew && px + pw > ex && pt < et && pt + ph > et - eh) {
-                            if (player.invulnTimer <= 0.0f) {
-                                player.health -= 1;
-                                player.invulnTimer = player.invuln;
-                                if (player.health < 0) player.health = 0;
-                            }
-                        }
-                    }
-
-                    // Check collision with boss
-                    if (selectedLevel == 10) {
-                        float bx = boss.x;
-                        float bw = boss.width;
-                        float bt = boss.y - boss.height;
-                        float bh = boss.height;
-                        float px = player.x;
-                        float pw = player.width;
-                        float pt = player.y - player.height;
-                        float ph = player.height;
-                        if (px < bx + bw && px + pw > bx && pt < bt + bh && pt + ph > bt) {
-                            if (boss.invulnTimer <= 0.0f) {
-                                boss.hp -= 1;
-                                boss.invulnTimer = boss.invuln;
-                            }
-                        }
-                    }
-
-                    // Check for game over conditions
-                    if (player.health <= 0) {
-                        playerLost = true;
-                        fade = 0.0f;
-                        running = false;
-                        if (globalDeadSound) Mix_PlayChannel(-1, globalDeadSound, 0);
-                    }
-                    if (player.x >= levelW - player.width && selectedLevel != 10) {
-                        playerWon = true;
-                        running = false;
-                    }
-                    if (selectedLevel == 10 && boss.hp <= 0) {
-                        playerWon = true;
-                        running = false;
-                    }
-                }
-
-                // clamp player to level bounds (physics units)
-                if (levelW > 0) {
-                    if (player.x < 0.f) player.x = 0.f;
-                    float maxPlayerX = (float)std::max(0, levelW - player.width);
-                    if (player.x > maxPlayerX) player.x = maxPlayerX;
-                }
-                if (levelH_now > 0) {
-                    if (player.y > levelH_now - player.height) {
-                        player.health = 0;
-                    } else {
-                        if (player.y < 0.f) player.y = 0.f;
-                        float maxPlayerY = (float)std::max(0, levelH_now - player.height);
-                        if (player.y > maxPlayerY) { player.y = maxPlayerY; player.onGround = true; player.vy = 0.f; }
-                    }
-                }
-
                 // Camera: center on player in physics units, clamp to level bounds
-                float camTarget = player.x - ( (float)winW / (2.0f * renderScale) );
+                float camTarget = playerDrawX - ( (float)winW / (2.0f * renderScale) );
                 float maxCam = std::max(0.0f, (float)(levelW) - (float)winW / renderScale);
                 camX = std::max(0.0f, std::min(camTarget, maxCam));
 
@@ -825,7 +966,7 @@ int main(int argc, char* argv[]) {
                 float camWidthWorld = static_cast<float>(winW) / renderScale;
                 float maxCamWorld = std::max(0.0f, levelWorldW - camWidthWorld);
 
-                float playerCenter = player.x + (player.width * 0.5f);
+                float playerCenter = playerDrawX + (player.width * 0.5f);
                 float camTargetWorld = playerCenter - (camWidthWorld * 0.5f);
                 float camX_world = std::max(0.0f, std::min(maxCamWorld, camTargetWorld));
 
@@ -834,6 +975,12 @@ int main(int argc, char* argv[]) {
 
                 if (editMode) camX = editorCamX;
 
+                // Vertical camera: only levels taller than the window scroll
+                float maxCamY = std::max(0.0f, (float)((level.rows - (WINH / baseTilePixels + 1)) * physCellH));
+                float camTargetY = (playerDrawY - player.height * 0.5f) - (float)winH / (2.0f * renderScale);
+                camY = std::max(0.0f, std::min(maxCamY, camTargetY));
+                int camY_render = static_cast<int>(std::lround(camY * renderScale));
+
                 // Compute floating render-space camera for background rendering
                 float camX_render_f = camX * renderScale;
                 float camMax_render_f = maxCamWorld * renderScale;
@@ -856,233 +1003,72 @@ int main(int argc, char* argv[]) {
                 // Level background
                 level.renderBackground(ren);
 
-                // draw tiles using camX_render
-                for (int r = 0; r < level.rows; ++r) {
-                    for (int c = 0; c < level.cols; ++c) {
-                        int cell = 0;
-                        if (r >= 0 && r < (int)level.grid.size() && c >= 0 && c < (int)level.grid[r].size()) {
-                            cell = level.grid[r][c];
-                        }
-                        if (cell == 0) continue;
-
-                        int tileX_render = c * renderCellW - camX_render;
-                        int tileY_render = r * renderCellH;
-                        SDL_Rect dst{ tileX_render, tileY_render, renderCellW, renderCellH };
-
-                        switch (cell) {
-                            case 1:
-                                SDL_SetRenderDrawColor(ren, 128, 128, 128, 255);
-                                SDL_RenderFillRect(ren, &dst);
-                                break;
-                            case 2:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(woda.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, woda.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 3:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(piwo1.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, piwo1.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 4:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(piwo2.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, piwo2.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 5:
-                                if (editMode) {
-                                    SDL_SetRenderDrawColor(ren, 255, 0, 0, 255);
-                                    SDL_RenderFillRect(ren, &dst);
-                                }
-                                break;
-                            case 6:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(piwoKufel.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, piwoKufel.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 7:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(pollitroka.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, pollitroka.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 8:
-                            {
-                                int texW, texH;
-                                SDL_QueryTexture(piwoButelka.tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, piwoButelka.tex, nullptr, &dst);
-                            }
-                                break;
-                            case 9:
-                            {
-                                Texture* tex = ((r + c) % 2 == 0) ? &pollitrowka3 : &pollitrowka2;
-                                int texW, texH;
-                                SDL_QueryTexture(tex->tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, tex->tex, nullptr, &dst);
-                            }
-                                break;
-                            case 10:
-                            {
-                               Texture* tex = &zelazo;
-                                int texW, texH;
-                                SDL_QueryTexture(tex->tex, nullptr, nullptr, &texW, &texH);
-                                float aspect = (float)texW / texH;
-                                int renderH = renderCellH;
-                                int renderW = (int)(renderH * aspect + 0.5f);
-                                int offsetX = (renderCellW - renderW) / 2;
-                                SDL_Rect dst{ tileX_render + offsetX, tileY_render, renderW, renderH };
-                                SDL_RenderCopy(ren, tex->tex, nullptr, &dst);
-                            }
-                            default:
-                                SDL_SetRenderDrawColor(ren, 100, 100, 100, 255);
-                                SDL_RenderFillRect(ren, &dst);
-                                break;
-                        }
-                    }
-                }
+                // draw the visible tiles using camX_render / camY_render
+                tileLayer.render(ren, level, camX_render, camY_render, winW, winH, renderCellW, renderCellH, editMode);
+
+                // Sprites are queued in draw order and culled to the window, then drawn in one go
+                sprites.begin(SDL_Rect{ 0, 0, winW, winH });
 
                 // render player once using same camX_render
-                player.render(ren, camX_render, 0, renderScale);
+                player.render(sprites, camX_render, camY_render, renderScale, alpha);
 
                 // Render projectiles
                 for (auto& p : projectiles) {
-                    SDL_Rect dst = { (int)(p.x - camX_render), (int)(p.y), p.width, p.height };
-                    SDL_RenderCopy(ren, p.tex->tex, nullptr, &dst);
+                    float drawX = p.prevX + (p.x - p.prevX) * alpha;
+                    float drawY = p.prevY + (p.y - p.prevY) * alpha;
+                    SDL_Rect dst = { (int)(drawX - camX_render), (int)(drawY - camY_render), p.width, p.height };
+                    sprites.draw(*p.tex, dst);
                 }
 
                 // Render boss
                 if (selectedLevel == 10) {
-                    boss.render(ren, camX_render, 0, renderTileScale);
+                    boss.render(sprites, camX_render, camY_render, renderTileScale, alpha);
                 }
                 // render enemies
-                for (auto& enemy : enemies) {
-                    enemy.render(ren, camX_render, 0, renderScale);
+                {
+                    // Guards only move a fraction of a pixel per step, so their width of slack
+                    // covers the interpolated positions
+                    float viewW = (float)winW / renderScale;
+                    enemies.render(sprites, camX_render, camY_render, renderScale, alpha,
+                                   enemies.lowerBound(camX - 2.0f * enemies.width), enemies.upperBound(camX + viewW + enemies.width));
                 }
 
                 // Render blood
                 for (auto& b : bloods) {
-                    SDL_SetRenderDrawColor(ren, 255, 0, 0, 255);
-                     SDL_Rect dst = { (int)(b.x - camX_render), (int)b.y, 8, 8 };
-                    SDL_RenderFillRect(ren, &dst);
+                    SDL_Rect dst = { (int)(b.x - camX_render), (int)(b.y - camY_render), 8, 8 };
+                    sprites.fill(dst, SDL_Color{ 255, 0, 0, 255 });
                 }
+                sprites.flush(ren);
 
                 // HUD/menu rendering
                 menu.render();
 
+                // HUD text goes through the sprite batch, one draw for all of it
+                sprites.begin(SDL_Rect{ 0, 0, WINW, WINH });
                 if (!editMode) {
                     SDL_Color color = {0, 0, 0, 255};
-                    std::string scoreText = "Punkty: " + std::to_string(player.score);
-                    std::string healthText = "HP: " + std::to_string(player.health);
-                    std::string fpsText = "FPS: " + std::to_string((int)(1.0 / dt));
-
-                    SDL_Surface* surf1 = TTF_RenderUTF8_Blended(hudFont, scoreText.c_str(), color);
-                    if (surf1) {
-                        SDL_Texture* tex1 = SDL_CreateTextureFromSurface(ren, surf1);
-                        if (tex1) {
-                            int w, h;
-                            SDL_QueryTexture(tex1, nullptr, nullptr, &w, &h);
-                            SDL_Rect dst = {WINW - w - 10, 10, w, h};
-                            SDL_RenderCopy(ren, tex1, nullptr, &dst);
-                            SDL_DestroyTexture(tex1);
-                        }
-                        SDL_FreeSurface(surf1);
-                    }
-
-                    SDL_Surface* surf2 = TTF_RenderUTF8_Blended(hudFont, healthText.c_str(), color);
-                    if (surf2) {
-                        SDL_Texture* tex2 = SDL_CreateTextureFromSurface(ren, surf2);
-                        if (tex2) {
-                            int w, h;
-                            SDL_QueryTexture(tex2, nullptr, nullptr, &w, &h);
-                            SDL_Rect dst = {10, 10, w, h};
-                            SDL_RenderCopy(ren, tex2, nullptr, &dst);
-                            SDL_DestroyTexture(tex2);
-                        }
-                        SDL_FreeSurface(surf2);
-                    }
+                    scoreLabel.set(hudGlyphs, "Punkty: " + std::to_string(player.score));
+                    healthLabel.set(hudGlyphs, "HP: " + std::to_string(player.health));
+                    scoreLabel.draw(sprites, WINW - scoreLabel.width() - 10, 10, color);
+                    healthLabel.draw(sprites, 10, 10, color);
 
                     SDL_Color green = {0, 255, 0, 255};
-                    std::string centerText;
                     SDL_Color centerColor = green;
                     if (selectedLevel == 10) {
-                        centerText = "Boss HP: " + std::to_string((int)boss.hp);
+                        centerLabel.set(hudGlyphs, "Boss HP: " + std::to_string((int)boss.hp));
                         centerColor = {255, 0, 0, 255};
                     } else {
-                        centerText = currentFpsText;
-                    }
-                    SDL_Surface* surf3 = TTF_RenderUTF8_Blended(hudFont, centerText.c_str(), centerColor);
-                    if (surf3) {
-                        SDL_Texture* tex3 = SDL_CreateTextureFromSurface(ren, surf3);
-                        if (tex3) {
-                            int w, h;
-                            SDL_QueryTexture(tex3, nullptr, nullptr, &w, &h);
-                            SDL_Rect dst = {WINW / 2 - w / 2, 10, w, h};
-                            SDL_RenderCopy(ren, tex3, nullptr, &dst);
-                            SDL_DestroyTexture(tex3);
-                        }
-                        SDL_FreeSurface(surf3);
+                        centerLabel.set(hudGlyphs, currentFpsText);
                     }
+                    centerLabel.draw(sprites, WINW / 2 - centerLabel.width() / 2, 10, centerColor);
                 }
 
                     if (editMode) {
                         SDL_Color color = {0, 0, 0, 255};
-                        SDL_Surface* surf = TTF_RenderUTF8_Blended(hudFont, "Edytor: strzałki - ruch, lewy myszki - klocek (0=pusty,1=twardy,2=szkodliwy,3=bonus,5=wróg)", color);
-                        if (surf) {
-                            SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-                            if (tex) {
-                                int w, h;
-                                SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
-                                SDL_Rect dst = {10, 10, w, h};
-                                SDL_RenderCopy(ren, tex, nullptr, &dst);
-                                SDL_DestroyTexture(tex);
-                            }
-                            SDL_FreeSurface(surf);
-                        }
+                        editorLabel.set(hudGlyphs, "Edytor: strzałki - ruch, lewy myszki - klocek (0=pusty,1=twardy,2=szkodliwy,3=bonus,5=wróg)");
+                        editorLabel.draw(sprites, 10, 10, color);
                     }
+                    sprites.flush(ren);
 
                     // Render game over screens
                     if (playerLost) {
@@ -1092,35 +1078,17 @@ int main(int argc, char* argv[]) {
                         SDL_SetRenderDrawColor(ren, 0, 0, 0, (Uint8)fade);
                         SDL_RenderFillRect(ren, nullptr);
 
-                        SDL_Color color = {255, 0, 0, 255};
-                        SDL_Surface* surf = TTF_RenderUTF8_Blended(hudFont, "Przegrałeś", color);
-                        if (surf) {
-                            SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-                            if (tex) {
-                                int w, h;
-                                SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
-                                SDL_Rect dst = {WINW / 2 - w / 2, WINH / 2 - h / 2, w, h};
-                                SDL_RenderCopy(ren, tex, nullptr, &dst);
-                                SDL_DestroyTexture(tex);
-                            }
-                            SDL_FreeSurface(surf);
-                        }
+                        endLabel.set(hudGlyphs, "Przegrałeś");
+                        sprites.begin(SDL_Rect{ 0, 0, WINW, WINH });
+                        endLabel.draw(sprites, WINW / 2 - endLabel.width() / 2, WINH / 2 - endLabel.height() / 2, SDL_Color{255, 0, 0, 255});
+                        sprites.flush(ren);
                     } else if (playerWon) {
                         SDL_SetRenderDrawColor(ren, 102, 51, 153, 255);
                         SDL_RenderFillRect(ren, nullptr);
-                        SDL_Color color = {255, 215, 0, 255};
-                        SDL_Surface* surf = TTF_RenderUTF8_Blended(hudFont, "Wygrałeś", color);
-                        if (surf) {
-                            SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-                            if (tex) {
-                                int w, h;
-                                SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
-                                SDL_Rect dst = {WINW / 2 - w / 2, WINH / 2 - h / 2, w, h};
-                                SDL_RenderCopy(ren, tex, nullptr, &dst);
-                                SDL_DestroyTexture(tex);
-                            }
-                            SDL_FreeSurface(surf);
-                        }
+                        endLabel.set(hudGlyphs, "Wygrałeś");
+                        sprites.begin(SDL_Rect{ 0, 0, WINW, WINH });
+                        endLabel.draw(sprites, WINW / 2 - endLabel.width() / 2, WINH / 2 - endLabel.height() / 2, SDL_Color{255, 215, 0, 255});
+                        sprites.flush(ren);
                     }
 
                     SDL_RenderPresent(ren);
@@ -1141,39 +1109,19 @@ int main(int argc, char* argv[]) {
                         }
                     }
 
-                    // Re-render the last screen
+                    // Re-render the last screen; endLabel is already laid out
                     if (playerLost) {
                         SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
                         SDL_RenderFillRect(ren, nullptr);
-                        SDL_Color color = {255, 0, 0, 255};
-                        SDL_Surface* surf = TTF_RenderUTF8_Blended(hudFont, "Przegrałeś", color);
-                        if (surf) {
-                            SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-                            if (tex) {
-                                int w, h;
-                                SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
-                                SDL_Rect dst = {WINW / 2 - w / 2, WINH / 2 - h / 2, w, h};
-                                SDL_RenderCopy(ren, tex, nullptr, &dst);
-                                SDL_DestroyTexture(tex);
-                            }
-                            SDL_FreeSurface(surf);
-                        }
                     } else if (playerWon) {
                         SDL_SetRenderDrawColor(ren, 102, 51, 153, 255);
                         SDL_RenderFillRect(ren, nullptr);
-                        SDL_Color color = {255, 215, 0, 255};
-                        SDL_Surface* surf = TTF_RenderUTF8_Blended(hudFont, "Wygrałeś", color);
-                        if (surf) {
-                            SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-                            if (tex) {
-                                int w, h;
-                                SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
-                                SDL_Rect dst = {WINW / 2 - w / 2, WINH / 2 - h / 2, w, h};
-                                SDL_RenderCopy(ren, tex, nullptr, &dst);
-                                SDL_DestroyTexture(tex);
-                            }
-                            SDL_FreeSurface(surf);
-                        }
+                    }
+                    if (playerLost || playerWon) {
+                        sprites.begin(SDL_Rect{ 0, 0, WINW, WINH });
+                        endLabel.draw(sprites, WINW / 2 - endLabel.width() / 2, WINH / 2 - endLabel.height() / 2,
+                                      playerLost ? SDL_Color{255, 0, 0, 255} : SDL_Color{255, 215, 0, 255});
+                        sprites.flush(ren);
                     }
 
                     SDL_RenderPresent(ren);
@@ -1190,12 +1138,17 @@ int main(int argc, char* argv[]) {
                 }
 
                 // Cleanup for this level
+                saver.finish(level);
                 delete editor;
                 editor = nullptr;
             }
 
             // cleanup
-            if(hudFont) TTF_CloseFont(hudFont);
+            preloader.shutdown();
+            saver.shutdown();
+            backgrounds.clear();
+            hudGlyphs.clear();
+            fonts.clear();
             Mix_FreeMusic(menuMusic);
             Mix_FreeMusic(levelMusic);
             Mix_FreeMusic(bossMusic);
@@ -0,0 +1,182 @@
+// Validates a level pack in parallel and optionally re-encodes it.
+// Usage: projekcik-levels [--jobs N] [--convert bin|text] [--assets <dir>] <dir or level zip>...
+// Every level_*.zip in the given directories is loaded with Level::loadFromFile and checked
+// (dimensions, tile values, enemy positions, background); timings and sizes are reported.
+#include "Level.h"
+#include "Tiles.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct LevelReport {
+    std::string path;
+    bool loaded = false;
+    int rows = 0, cols = 0;
+    size_t enemies = 0;
+    bool streamed = false;
+    uintmax_t sizeBefore = 0, sizeAfter = 0;
+    double loadMs = 0.0, convertMs = 0.0, reloadMs = 0.0;
+    std::vector<std::string> problems;
+};
+
+static bool isLevelArchive(const fs::path& p) {
+    std::string name = p.filename().string();
+    return name.size() > 10 && name.compare(0, 6, "level_") == 0 && p.extension() == ".zip";
+}
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void checkLevel(const Level& level, LevelReport& report) {
+    auto problem = [&](const std::string& text) { report.problems.push_back(text); };
+
+    if (level.rows <= 0 || level.cols <= 0) problem("empty level");
+    if (!level.isStreamed()) {
+        if (level.gridRows != level.rows || level.gridCols != level.cols || level.gridStride < level.cols ||
+            level.grid.size() < (size_t)level.rows * level.gridStride) {
+            problem("grid is " + std::to_string(level.gridRows) + "x" + std::to_string(level.gridCols) +
+                    " (" + std::to_string(level.grid.size()) + " tiles)");
+        }
+    }
+
+    uint32_t counts[256] = {};
+    level.countTiles(counts);
+    for (int v = Tiles::KNOWN_COUNT; v < 256; ++v) {
+        if (counts[v]) problem(std::to_string(counts[v]) + " tiles with unknown value " + std::to_string(v));
+    }
+
+    std::set<std::pair<int, int>> seen;
+    for (const auto& e : level.enemyPositions) {
+        std::string at = std::to_string(e.first) + "," + std::to_string(e.second);
+        if (e.first < 0 || e.first >= level.rows || e.second < 0 || e.second >= level.cols) {
+            problem("enemy at " + at + " is outside the level");
+            continue;
+        }
+        if (!seen.insert(e).second) problem("duplicate enemy at " + at);
+        // Spawns are drawn on top of their tile; only empty or spawn tiles make sense
+        if (level.isResident(e.first, e.second)) {
+            int cell = level.tile(e.first, e.second);
+            if (cell != Tiles::EMPTY && cell != Tiles::ENEMY_SPAWN) problem("enemy at " + at + " sits on tile " + std::to_string(cell));
+        }
+    }
+
+    if (level.backgroundPath.empty()) problem("no background");
+    else if (level.backgroundData.empty()) problem("background " + level.backgroundPath + " is not embedded");
+    if (level.usedAssets.empty()) problem("empty assets.txt");
+}
+
+static void processLevel(LevelReport& report, bool convert, Level::LayoutFormat format, const std::string& assetsDir) {
+    std::error_code ec;
+    report.sizeBefore = fs::file_size(report.path, ec);
+
+    Level level;
+    auto start = std::chrono::steady_clock::now();
+    report.loaded = level.loadFromFile(report.path);
+    report.loadMs = msSince(start);
+    if (!report.loaded) {
+        report.problems.push_back("failed to load");
+        return;
+    }
+    report.rows = level.rows;
+    report.cols = level.cols;
+    report.enemies = level.enemyPositions.size();
+    report.streamed = level.isStreamed();
+    checkLevel(level, report);
+
+    if (!convert) return;
+    start = std::chrono::steady_clock::now();
+    if (!level.saveToZip(report.path, assetsDir, format)) {
+        report.problems.push_back("failed to write");
+        return;
+    }
+    report.convertMs = msSince(start);
+    report.sizeAfter = fs::file_size(report.path, ec);
+
+    Level reloaded;
+    start = std::chrono::steady_clock::now();
+    if (!reloaded.loadFromFile(report.path)) report.problems.push_back("failed to reload after writing");
+    report.reloadMs = msSince(start);
+}
+
+int main(int argc, char* argv[]) {
+    std::string assetsDir = "assets/";
+    bool convert = false;
+    Level::LayoutFormat format = Level::LayoutFormat::Binary;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--assets" && i + 1 < argc) {
+            assetsDir = argv[++i];
+            if (!assetsDir.empty() && assetsDir.back() != '/' && assetsDir.back() != '\\') assetsDir += '/';
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = (unsigned)std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--convert" && i + 1 < argc) {
+            std::string to = argv[++i];
+            if (to != "bin" && to != "text") {
+                std::cerr << "--convert takes bin or text\n";
+                return 2;
+            }
+            convert = true;
+            format = (to == "text") ? Level::LayoutFormat::Text : Level::LayoutFormat::Binary;
+        } else if (fs::is_directory(arg)) {
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(arg, ec)) {
+                if (entry.is_regular_file() && isLevelArchive(entry.path())) paths.push_back(entry.path().string());
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "usage: projekcik-levels [--jobs N] [--convert bin|text] [--assets <dir>] <dir or level zip>...\n";
+        return 2;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<LevelReport> reports(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) reports[i].path = paths[i];
+
+    // Levels are independent; workers take the next unclaimed one
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> workers;
+    jobs = std::min<unsigned>(jobs, (unsigned)paths.size());
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < reports.size(); i = next++) processLevel(reports[i], convert, format, assetsDir);
+        });
+    }
+    for (auto& t : workers) t.join();
+    double totalMs = msSince(start);
+
+    int failed = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : reports) {
+        std::cout << r.path << ": ";
+        if (r.loaded) {
+            std::cout << r.rows << "x" << r.cols << (r.streamed ? " (streamed)" : "") << ", " << r.enemies << " enemies, "
+                      << r.sizeBefore << " B, load " << r.loadMs << " ms";
+            if (convert && r.sizeAfter) {
+                std::cout << " -> " << r.sizeAfter << " B, write " << r.convertMs << " ms, reload " << r.reloadMs << " ms";
+            }
+        }
+        std::cout << (r.problems.empty() ? " OK" : "") << "\n";
+        for (const auto& p : r.problems) std::cout << "    " << p << "\n";
+        if (!r.problems.empty()) ++failed;
+    }
+    std::cout << reports.size() << " levels, " << failed << " with problems, " << totalMs << " ms on " << jobs << " threads\n";
+    return failed == 0 ? 0 : 1;
+}
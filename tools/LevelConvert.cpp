@@ -0,0 +1,53 @@
+// Rewrites level archives so they carry the binary layout.bin entry, or with --text a
+// hand-editable layout.txt with run-length encoded rows.
+// Usage: projekcik-levelconv [--assets <dir>] [--text] level_1.zip [level_2.zip ...]
+#include "Level.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::string assetsDir = "assets/";
+    Level::LayoutFormat format = Level::LayoutFormat::Binary;
+    int converted = 0, failed = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--assets" && i + 1 < argc) {
+            assetsDir = argv[++i];
+            if (!assetsDir.empty() && assetsDir.back() != '/' && assetsDir.back() != '\\') assetsDir += '/';
+            continue;
+        }
+        if (arg == "--text") {
+            format = Level::LayoutFormat::Text;
+            continue;
+        }
+
+        Level level;
+        if (!level.loadFromFile(arg)) {
+            std::cerr << arg << ": failed to load\n";
+            ++failed;
+            continue;
+        }
+
+        // Archives without an embedded background take it from assetsDir; refuse to drop it silently
+        if (level.backgroundData.empty() && !level.backgroundPath.empty() && !std::ifstream(assetsDir + level.backgroundPath, std::ios::binary)) {
+            std::cerr << arg << ": background " << assetsDir + level.backgroundPath << " not found, skipping\n";
+            ++failed;
+            continue;
+        }
+
+        if (!level.saveToZip(arg, assetsDir, format)) {
+            std::cerr << arg << ": failed to write\n";
+            ++failed;
+            continue;
+        }
+        std::cout << arg << ": " << level.rows << "x" << level.cols << ", "
+                  << level.enemyPositions.size() << " enemies -> "
+                  << (format == Level::LayoutFormat::Text ? "layout.txt" : "layout.bin") << "\n";
+        ++converted;
+    }
+
+    std::cout << converted << " converted, " << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}